@@ -0,0 +1,2003 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sox.h>
+
+#include "engine.h"
+#include "keymap.h"
+#include "opcodes/vochorus.h"
+#include "opcodes/vocparam.h"
+
+#define SAMPLE_READ_CHUNK 4096
+
+#define STREAMS 2
+
+#define VIB_SINE     1
+#define VIB_TRIANGLE 2
+#define VIB_SQUARE   3
+#define VIB_WACKY    4
+
+#define MIDI_NOTES 128
+#define MIDI_VELOCITIES 128
+#define MAX_ZONES 128
+#define MAX_ROUND_ROBIN 16
+#define NO_ZONE_GROUP UINT8_MAX
+#define BANK_PROGRAMS 128
+#define NO_PROGRAM -1
+
+#define DIALDOWN_STEP 0.3
+
+#define RENDER_CHUNK_PERIODS 32
+#define RENDER_ENTRIES       256
+#define NO_RENDER            -1
+#define NO_CHUNK             UINT32_MAX
+
+static const struct engine_expression NO_EXPRESSION = { 1, 1, 1 };
+#define NOTE_PAN_RANGE 87.0
+
+// decoded once per process and shared by every engine playing the path
+struct engine_sample {
+	char*   path;
+	double* left;
+	double* right;
+	size_t  len;
+	double  sample_rate;
+	double  dur;
+	bool    stereo;
+	// found once here so that playing only has to look them up
+	size_t* onsets;
+	size_t  onset_cnt;
+	// log spectral envelopes, VOCHORUS_ENVELOPE_BINS per frame, shared
+	// by every note and chorus voice that plays the sample
+	double* envelopes;
+	size_t  envelope_cnt;
+	// of the file as it was decoded, see get_sample_identity
+	uint64_t identity;
+	// of the decoded audio, so a saved session can tell it is the same
+	uint64_t hash;
+	// atomic, so that the audio thread can take and drop references
+	// without the lock
+	unsigned              refs;
+	struct engine_sample* next;
+};
+
+static pthread_mutex_t loaded_samples_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct engine_sample* loaded_samples = NULL;
+
+enum envelope_stage {
+	ENV_ATTACK,
+	ENV_DECAY,
+	ENV_SUSTAIN,
+	ENV_RELEASE,
+	ENV_DONE
+};
+
+// transegr: attack to 1, decay to sustain, hold, and on release go from
+// wherever the envelope is to 0
+struct envelope {
+	enum envelope_stage stage;
+	double              value;
+	double              start;
+	double              target;
+	double              shape;
+	uint64_t            pos;
+	uint64_t            len;
+	double              decay_time;
+	double              decay_shape;
+	double              sustain_level;
+	double              release_time;
+	double              release_shape;
+};
+
+struct stream {
+	struct vochorus chorus;
+	double*         out[MAX_OUTS];
+};
+
+// each branch of the pointer logic in instr 2 runs its own phasor
+struct voice_phasors {
+	double full;
+	double main;
+	double sustain;
+	double release;
+};
+
+struct voice {
+	bool                 active;
+	bool                 holds_sample;
+	bool                 note_off;
+	bool                 stop;
+	uint8_t              channel;
+	uint8_t              note;
+	double               main_loop_times;
+	double               release_loop_times;
+	double               sus_main_loop_limit;
+	double               main_loops;
+	double               release_loops;
+	double               dialdown;
+	double               vib_offset;
+	// the expression gain the last period ended on, to ramp from
+	double               gain;
+	// the render cache entry being played back or recorded, or
+	// NO_RENDER, and how far into it the voice is; a voice playing one
+	// back leaves its streams stopped until it needs them
+	int                  render;
+	bool                 replaying;
+	bool                 streams_started;
+	uint64_t             render_key;
+	size_t               render_period;
+	uint32_t             render_chunk;
+	struct engine_sample* sample;
+	struct voice_phasors phasors;
+	struct envelope      env;
+	unsigned             stream_cnt;
+	struct stream        streams[STREAMS];
+};
+
+// zones with the same ranges and round robin group, taking turns
+struct zone_group {
+	uint8_t  low_note;
+	uint8_t  high_note;
+	uint8_t  low_velocity;
+	uint8_t  high_velocity;
+	unsigned round_robin;
+	uint8_t  zone_cnt;
+	uint8_t  next;
+	uint8_t  zones[MAX_ROUND_ROBIN];
+};
+
+// every note and velocity points straight at its group, so picking a
+// zone on note on is a lookup rather than a search
+struct keymap {
+	struct engine_sample* samples[MAX_ZONES];
+	size_t                zone_cnt;
+	struct zone_group     groups[MAX_ZONES];
+	size_t                group_cnt;
+	uint8_t               lookup[MIDI_NOTES][MIDI_VELOCITIES];
+	char*                 path;
+	bool                  from_sample;
+	size_t                bytes;
+};
+
+struct engine_bank {
+	struct keymap* presets[BANK_PROGRAMS];
+	size_t         bytes;
+};
+
+// a channel without a keymap of its own plays whatever engine->keymap is
+struct engine_parts {
+	struct keymap* keymaps[ENGINE_CHANNELS];
+	size_t         bytes;
+};
+
+// one note's streams mixed down before the envelope, pan and pressure,
+// in chunks of the arena chained through next_chunk
+struct render_entry {
+	bool     used;
+	bool     recording;
+	unsigned players;
+	uint64_t key;
+	size_t   periods;
+	uint32_t first_chunk;
+	uint32_t last_chunk;
+	uint64_t last_used;
+};
+
+// the arena is allocated whole by prepare_engine_render_cache, so that
+// recording on the audio thread only takes chunks off the free list
+struct engine_render_cache {
+	size_t              bytes;
+	uint32_t            period_frames;
+	uint32_t            chunk_cnt;
+	double*             audio;
+	uint32_t*           next_chunk;
+	uint32_t            free_chunk;
+	uint64_t            clock;
+	struct render_entry entries[RENDER_ENTRIES];
+};
+
+struct channel_ratios {
+	struct vocparam_table speed;
+	struct vocparam_table pitch;
+};
+
+struct engine {
+	double                sample_rate;
+	uint32_t              ksmps;
+	double                kr;
+	struct vochorus_pool* pool;
+	// note on reads whichever keymap this points at, and a program
+	// change only swaps the pointer
+	struct keymap*        keymap;
+	struct keymap*        loose_keymap;
+	struct engine_bank*   bank;
+	struct engine_parts*  parts;
+	struct engine_render_cache* render_cache;
+	int                   program;
+	size_t                memory_bytes;
+	size_t                memory_limit;
+	// read by whichever thread prepares the next bank
+	size_t                bank_budget;
+	struct voice          voices[MAX_POLY];
+	double*               seek_points;
+	// a voice's streams mixed, whether rendered or played back
+	double*               mix[MAX_OUTS];
+	double                vib_phase;
+	double                vib;
+	struct channel_ratios ratios;
+	// only for channels whose settings differ from the ports'
+	struct channel_ratios part_ratios[ENGINE_CHANNELS];
+	// the latest on each channel, and what each voice plays with,
+	// indexed like voices
+	struct engine_expression channel_expression[ENGINE_CHANNELS];
+	struct engine_expression expression[MAX_POLY];
+	// what the audio thread can't print or free itself: notes there was
+	// no voice for, and samples a voice let go of after their keymap had
+	// already been freed, left for release_engine_retired
+	size_t                dropped_notes;
+	struct engine_sample* retired[MAX_POLY];
+};
+
+static double* alloc_period(const struct engine* engine)
+{
+	return (double*)calloc(engine->ksmps, sizeof(double));
+}
+
+struct engine* create_engine(const double sample_rate,
+                             const uint32_t control_period_frames)
+{
+	struct engine* engine = (struct engine*)calloc(1, sizeof(struct engine));
+	if (!engine)
+		return NULL;
+	engine->sample_rate = sample_rate;
+	engine->ksmps = control_period_frames;
+	engine->kr = sample_rate / control_period_frames;
+	engine->program = NO_PROGRAM;
+	for (size_t i = 0; i < ENGINE_CHANNELS; i++)
+		engine->channel_expression[i] = NO_EXPRESSION;
+	for (size_t i = 0; i < MAX_POLY; i++)
+		engine->expression[i] = NO_EXPRESSION;
+
+	import_vochorus_wisdom();
+	engine->pool = create_vochorus_pool();
+	if (!engine->pool) {
+		free(engine);
+		return NULL;
+	}
+
+	engine->seek_points = alloc_period(engine);
+	bool allocated = engine->seek_points != NULL;
+	for (size_t i = 0; i < MAX_OUTS; i++) {
+		engine->mix[i] = alloc_period(engine);
+		allocated = allocated && engine->mix[i];
+	}
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct voice* voice = &engine->voices[i];
+		voice->render = NO_RENDER;
+		for (size_t j = 0; j < STREAMS; j++) {
+			for (size_t k = 0; k < MAX_OUTS; k++) {
+				voice->streams[j].out[k] = alloc_period(engine);
+				allocated = allocated &&
+				            voice->streams[j].out[k];
+			}
+		}
+	}
+	if (!allocated) {
+		destroy_engine(engine);
+		return NULL;
+	}
+
+	return engine;
+}
+
+static void free_engine_sample(struct engine_sample* sample)
+{
+	if (sample->right != sample->left)
+		free(sample->right);
+	free(sample->left);
+	free(sample->onsets);
+	free(sample->envelopes);
+	free(sample->path);
+	free(sample);
+}
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME  0x100000001b3ULL
+
+// FNV-1a, cheap next to the decode it rides along with
+static uint64_t hash_bytes(uint64_t hash, const void* data, const size_t len)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+uint64_t hash_sample_path(const char* path)
+{
+	return hash_bytes(FNV_OFFSET, path, strlen(path));
+}
+
+// 0 when there is no file to stat
+uint64_t get_sample_identity(const char* path)
+{
+	struct stat info;
+	if (stat(path, &info))
+		return 0;
+
+	const uint64_t fields[] = {
+		(uint64_t)info.st_dev,
+		(uint64_t)info.st_ino,
+		(uint64_t)info.st_size,
+		(uint64_t)info.st_mtim.tv_sec,
+		(uint64_t)info.st_mtim.tv_nsec
+	};
+	return hash_bytes(hash_sample_path(path), fields, sizeof(fields));
+}
+
+// a reference on a sample that has none left would come too late, it
+// is already on its way to being freed
+static bool retain_live_sample(struct engine_sample* sample)
+{
+	unsigned refs = __atomic_load_n(&sample->refs, __ATOMIC_RELAXED);
+	do {
+		if (refs == 0)
+			return false;
+	} while (!__atomic_compare_exchange_n(&sample->refs,
+	                                      &refs,
+	                                      refs + 1,
+	                                      true,
+	                                      __ATOMIC_RELAXED,
+	                                      __ATOMIC_RELAXED));
+	return true;
+}
+
+// the identity settles it but for a collision, and a hash of 0 takes
+// whatever audio the file held; with a reference taken on what it
+// returns
+static struct engine_sample* retain_loaded_sample(const char* path,
+                                                  const uint64_t identity,
+                                                  const uint64_t hash)
+{
+	for (struct engine_sample* s = loaded_samples; s; s = s->next)
+		if (s->identity == identity &&
+		    (hash == 0 || s->hash == hash) &&
+		    !strcmp(s->path, path) &&
+		    retain_live_sample(s))
+			return s;
+	return NULL;
+}
+
+static void unlist_sample(struct engine_sample* sample)
+{
+	for (struct engine_sample** link = &loaded_samples;
+	     *link;
+	     link = &(*link)->next) {
+		if (*link == sample) {
+			*link = sample->next;
+			return;
+		}
+	}
+}
+
+static void retain_sample(struct engine_sample* sample)
+{
+	__atomic_add_fetch(&sample->refs, 1, __ATOMIC_RELAXED);
+}
+
+// voices still holding one of these keep it until they end
+static void unlist_stale_samples(const char* path)
+{
+	struct engine_sample** link = &loaded_samples;
+	while (*link) {
+		if (!strcmp((*link)->path, path))
+			*link = (*link)->next;
+		else
+			link = &(*link)->next;
+	}
+}
+
+static void release_sample(struct engine_sample* sample)
+{
+	if (__atomic_sub_fetch(&sample->refs, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+	pthread_mutex_lock(&loaded_samples_lock);
+	unlist_sample(sample);
+	pthread_mutex_unlock(&loaded_samples_lock);
+	free_engine_sample(sample);
+}
+
+// the last reference can mean freeing megabytes, so the audio thread
+// only drops one that isn't and leaves the last in a slot; with every
+// slot taken it keeps it, still listed for the next load of its path
+static void retire_sample(struct engine* engine, struct engine_sample* sample)
+{
+	unsigned refs = __atomic_load_n(&sample->refs, __ATOMIC_RELAXED);
+	while (refs > 1)
+		if (__atomic_compare_exchange_n(&sample->refs,
+		                                &refs,
+		                                refs - 1,
+		                                true,
+		                                __ATOMIC_RELEASE,
+		                                __ATOMIC_RELAXED))
+			return;
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct engine_sample* empty = NULL;
+		if (__atomic_compare_exchange_n(&engine->retired[i],
+		                                &empty,
+		                                sample,
+		                                false,
+		                                __ATOMIC_RELEASE,
+		                                __ATOMIC_RELAXED))
+			return;
+	}
+}
+
+void release_engine_retired(struct engine* engine)
+{
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct engine_sample* sample =
+		        __atomic_exchange_n(&engine->retired[i],
+		                            NULL,
+		                            __ATOMIC_ACQUIRE);
+		if (sample)
+			release_sample(sample);
+	}
+}
+
+void size_engine_machinery(struct engine* engine, const double fft_size)
+{
+	size_vochorus_pool(engine->pool, fft_size);
+}
+
+size_t take_engine_dropped_notes(struct engine* engine)
+{
+	return __atomic_exchange_n(&engine->dropped_notes,
+	                           0,
+	                           __ATOMIC_RELAXED) +
+	       take_vochorus_dropped(engine->pool);
+}
+
+static void free_stream(struct stream* stream)
+{
+	stop_vochorus(&stream->chorus);
+	for (size_t i = 0; i < MAX_OUTS; i++)
+		free(stream->out[i]);
+}
+
+static void normalize(double* const channel, const size_t len)
+{
+	// like GEN01 with a positive table number
+	double peak = 0;
+	for (size_t i = 0; i < len; i++)
+		if (fabs(channel[i]) > peak)
+			peak = fabs(channel[i]);
+	if (peak > 0)
+		for (size_t i = 0; i < len; i++)
+			channel[i] /= peak;
+}
+
+static inline double sox_to_double(const sox_sample_t sample)
+{
+	return sample / (SOX_SAMPLE_MAX + 1.0);
+}
+
+// leaves the sample as it was if either channel can't grow
+static bool grow_sample(struct engine_sample* sample, const size_t capacity)
+{
+	double* const left = (double*)realloc(sample->left,
+	                                      sizeof(double) * capacity);
+	if (!left)
+		return false;
+	sample->left = left;
+	if (!sample->stereo) {
+		sample->right = left;
+		return true;
+	}
+	double* const right = (double*)realloc(sample->right,
+	                                       sizeof(double) * capacity);
+	if (!right)
+		return false;
+	sample->right = right;
+	return true;
+}
+
+static struct engine_sample* decode_sample(const char* path)
+{
+	sox_format_t* file = sox_open_read(path, NULL, NULL, NULL);
+	if (!file) {
+		fprintf(stderr, "Unable to read from %s\n", path);
+		return NULL;
+	}
+
+	unsigned channels = file->signal.channels;
+	if (channels < 1)
+		channels = 1;
+	sox_rate_t sample_rate = file->signal.rate;
+	if (sample_rate < 1)
+		sample_rate = 1;
+
+	struct engine_sample* sample =
+	        (struct engine_sample*)calloc(1, sizeof(struct engine_sample));
+	if (!sample) {
+		fprintf(stderr, "Out of memory reading %s\n", path);
+		sox_close(file);
+		return NULL;
+	}
+	sample->stereo = channels > 1;
+	size_t capacity = file->signal.length / channels;
+	if (capacity == 0)
+		capacity = SAMPLE_READ_CHUNK;
+
+	sox_sample_t* chunk =
+	        (sox_sample_t*)malloc(sizeof(sox_sample_t) *
+	                              SAMPLE_READ_CHUNK * channels);
+	bool no_memory = !chunk || !grow_sample(sample, capacity);
+	uint64_t hash = FNV_OFFSET;
+	size_t read;
+	while (!no_memory &&
+	       (read = sox_read(file,
+	                        chunk,
+	                        SAMPLE_READ_CHUNK * channels)) > 0) {
+		hash = hash_bytes(hash, chunk, sizeof(sox_sample_t) * read);
+		const size_t frames = read / channels;
+		if (sample->len + frames > capacity) {
+			size_t grown = capacity;
+			while (sample->len + frames > grown)
+				grown *= 2;
+			if (!grow_sample(sample, grown)) {
+				no_memory = true;
+				break;
+			}
+			capacity = grown;
+		}
+		for (size_t i = 0; i < frames; i++) {
+			const sox_sample_t* const frame = &chunk[i * channels];
+			sample->left[sample->len + i] = sox_to_double(frame[0]);
+			if (sample->stereo)
+				sample->right[sample->len + i] =
+				        sox_to_double(frame[1]);
+		}
+		sample->len += frames;
+	}
+	free(chunk);
+	sox_close(file);
+
+	if (no_memory) {
+		fprintf(stderr, "Out of memory reading %s\n", path);
+		free_engine_sample(sample);
+		return NULL;
+	}
+	if (sample->len == 0) {
+		fprintf(stderr, "No audio in %s\n", path);
+		free_engine_sample(sample);
+		return NULL;
+	}
+
+	normalize(sample->left, sample->len);
+	if (sample->stereo)
+		normalize(sample->right, sample->len);
+	sample->sample_rate = sample_rate;
+	sample->dur = (double)sample->len / sample_rate;
+	sample->hash = hash;
+	sample->path = strdup(path);
+	if (!sample->path ||
+	    !detect_vochorus_onsets(sample->left,
+	                            sample->right,
+	                            sample->len,
+	                            sample_rate,
+	                            &sample->onsets,
+	                            &sample->onset_cnt) ||
+	    !analyse_vochorus_envelopes(sample->left,
+	                                sample->right,
+	                                sample->len,
+	                                &sample->envelopes,
+	                                &sample->envelope_cnt)) {
+		fprintf(stderr, "Out of memory analysing %s\n", path);
+		free_engine_sample(sample);
+		return NULL;
+	}
+	return sample;
+}
+
+// a loaded sample only counts while the file is unchanged, and with a
+// hash only if it is the same audio; a fresh decode replaces whatever
+// stale copy is listed under the path
+static struct engine_sample* acquire_sample(const char* path,
+                                            const uint64_t hash)
+{
+	const uint64_t identity = get_sample_identity(path);
+	pthread_mutex_lock(&loaded_samples_lock);
+	struct engine_sample* sample = retain_loaded_sample(path,
+	                                                    identity,
+	                                                    hash);
+	pthread_mutex_unlock(&loaded_samples_lock);
+	if (sample)
+		return sample;
+
+	// decode without the lock, other instances may be loading too
+	struct engine_sample* decoded = decode_sample(path);
+	if (!decoded)
+		return NULL;
+	if (hash != 0 && decoded->hash != hash)
+		fprintf(stderr, "WARN: %s has changed since it was saved\n", path);
+
+	pthread_mutex_lock(&loaded_samples_lock);
+	decoded->identity = identity;
+	sample = retain_loaded_sample(path, identity, decoded->hash);
+	if (!sample) {
+		unlist_stale_samples(path);
+		sample = decoded;
+		sample->refs = 1;
+		sample->next = loaded_samples;
+		loaded_samples = sample;
+	}
+	pthread_mutex_unlock(&loaded_samples_lock);
+
+	if (sample != decoded)
+		free_engine_sample(decoded);
+	return sample;
+}
+
+static bool same_group(const struct zone_group* group,
+                       const struct keymap_zone* zone)
+{
+	return zone->round_robin != 0 &&
+	       group->round_robin   == zone->round_robin &&
+	       group->low_note      == zone->low_note &&
+	       group->high_note     == zone->high_note &&
+	       group->low_velocity  == zone->low_velocity &&
+	       group->high_velocity == zone->high_velocity;
+}
+
+static struct zone_group* find_zone_group(struct keymap* keymap,
+                                          const struct keymap_zone* zone)
+{
+	for (size_t i = 0; i < keymap->group_cnt; i++) {
+		struct zone_group* group = &keymap->groups[i];
+		if (same_group(group, zone))
+			return group;
+	}
+	return NULL;
+}
+
+// only once the zone's sample has loaded, so that no note lands on a
+// group without any zones
+static struct zone_group* new_zone_group(struct keymap* keymap,
+                                         const struct keymap_zone* zone)
+{
+	if (keymap->group_cnt == MAX_ZONES)
+		return NULL;
+
+	struct zone_group* group = &keymap->groups[keymap->group_cnt];
+	memset(group, '\0', sizeof(struct zone_group));
+	group->low_note      = zone->low_note;
+	group->high_note     = zone->high_note;
+	group->low_velocity  = zone->low_velocity;
+	group->high_velocity = zone->high_velocity;
+	group->round_robin   = zone->round_robin;
+
+	const uint8_t index = keymap->group_cnt++;
+	for (unsigned note = zone->low_note; note <= zone->high_note; note++)
+		for (unsigned vel = zone->low_velocity;
+		     vel <= zone->high_velocity;
+		     vel++)
+			keymap->lookup[note][vel] = index;
+	return group;
+}
+
+static bool add_zone(struct keymap* keymap,
+                     const struct keymap_zone* zone,
+                     const uint64_t hash)
+{
+	if (keymap->zone_cnt == MAX_ZONES) {
+		fprintf(stderr, "WARN: only %d zones are supported\n", MAX_ZONES);
+		return false;
+	}
+	struct zone_group* group = find_zone_group(keymap, zone);
+	if (group && group->zone_cnt == MAX_ROUND_ROBIN) {
+		fprintf(stderr,
+		        "WARN: only %d zones can take turns, skipping %s\n",
+		        MAX_ROUND_ROBIN,
+		        zone->path);
+		return false;
+	}
+
+	struct engine_sample* sample = acquire_sample(zone->path, hash);
+	if (!sample)
+		return false;
+
+	if (!group)
+		group = new_zone_group(keymap, zone);
+	if (!group) {
+		release_sample(sample);
+		return false;
+	}
+	group->zones[group->zone_cnt++] = keymap->zone_cnt;
+	keymap->samples[keymap->zone_cnt++] = sample;
+	return true;
+}
+
+void free_engine_keymap(struct keymap* keymap)
+{
+	if (!keymap)
+		return;
+	for (size_t i = 0; i < keymap->zone_cnt; i++)
+		release_sample(keymap->samples[i]);
+	free(keymap->path);
+	free(keymap);
+}
+
+static size_t sample_bytes(const struct engine_sample* sample)
+{
+	return sample->len * sizeof(double) * (sample->stereo ? 2 : 1) +
+	       sample->onset_cnt * sizeof(size_t) +
+	       sample->envelope_cnt * VOCHORUS_ENVELOPE_BINS * sizeof(double);
+}
+
+// samples shared between zones or presets only count once
+static size_t keymaps_bytes(struct keymap* const* keymaps,
+                            const size_t keymap_cnt)
+{
+	size_t total = 0;
+	for (size_t i = 0; i < keymap_cnt; i++) {
+		if (!keymaps[i])
+			continue;
+		for (size_t j = 0; j < keymaps[i]->zone_cnt; j++) {
+			const struct engine_sample* sample = keymaps[i]->samples[j];
+			bool counted = false;
+			for (size_t k = 0; k <= i && !counted; k++) {
+				if (!keymaps[k])
+					continue;
+				const size_t zones = k == i ? j : keymaps[k]->zone_cnt;
+				for (size_t l = 0; l < zones && !counted; l++)
+					counted = keymaps[k]->samples[l] == sample;
+			}
+			if (!counted)
+				total += sample_bytes(sample);
+		}
+	}
+	return total;
+}
+
+// only a lone sample has a hash to hold its zone to
+static struct keymap* create_keymap(const char* path,
+                                    const struct keymap_zone* zones,
+                                    const size_t zone_cnt,
+                                    const uint64_t hash)
+{
+	struct keymap* keymap = (struct keymap*)malloc(sizeof(struct keymap));
+	if (!keymap)
+		return NULL;
+	keymap->zone_cnt = 0;
+	keymap->group_cnt = 0;
+	memset(keymap->lookup, NO_ZONE_GROUP, sizeof(keymap->lookup));
+	for (size_t i = 0; i < zone_cnt; i++)
+		add_zone(keymap, &zones[i], hash);
+
+	if (keymap->zone_cnt == 0) {
+		free(keymap);
+		return NULL;
+	}
+	keymap->path = strdup(path);
+	if (!keymap->path) {
+		free_engine_keymap(keymap);
+		return NULL;
+	}
+	keymap->from_sample = false;
+	keymap->bytes = keymaps_bytes(&keymap, 1);
+	return keymap;
+}
+
+struct keymap* prepare_engine_sample(const char* path, const uint64_t hash)
+{
+	const struct keymap_zone everywhere = {
+		.path          = (char*)path,
+		.low_note      = 0,
+		.high_note     = MIDI_NOTES - 1,
+		.low_velocity  = 0,
+		.high_velocity = MIDI_VELOCITIES - 1,
+		.round_robin   = 0
+	};
+	struct keymap* keymap = create_keymap(path, &everywhere, 1, hash);
+	if (keymap)
+		keymap->from_sample = true;
+	return keymap;
+}
+
+struct keymap* prepare_engine_keymap(const char* path)
+{
+	size_t zone_cnt;
+	struct keymap_zone* zones = read_keymap(path, &zone_cnt);
+	if (!zones)
+		return NULL;
+	struct keymap* keymap = create_keymap(path, zones, zone_cnt, 0);
+	free_keymap_zones(zones, zone_cnt);
+	return keymap;
+}
+
+uint64_t get_engine_keymap_hash(const struct keymap* keymap)
+{
+	return keymap->from_sample ? keymap->samples[0]->hash : 0;
+}
+
+uint64_t get_engine_keymap_identity(const struct keymap* keymap)
+{
+	return keymap->from_sample ? keymap->samples[0]->identity : 0;
+}
+
+void free_engine_bank(struct engine_bank* bank)
+{
+	if (!bank)
+		return;
+	for (size_t i = 0; i < BANK_PROGRAMS; i++)
+		free_engine_keymap(bank->presets[i]);
+	free(bank);
+}
+
+// every preset is decoded up front so that switching never waits on a file
+struct engine_bank* prepare_engine_bank(const char* path, const size_t budget)
+{
+	size_t entry_cnt;
+	struct bank_entry* entries = read_bank(path, &entry_cnt);
+	if (!entries)
+		return NULL;
+
+	struct engine_bank* bank =
+	        (struct engine_bank*)calloc(1, sizeof(struct engine_bank));
+	if (!bank) {
+		free_bank_entries(entries, entry_cnt);
+		return NULL;
+	}
+	for (size_t i = 0; i < entry_cnt; i++) {
+		const struct bank_entry* entry = &entries[i];
+		struct keymap* keymap = entry->is_keymap ?
+		                        prepare_engine_keymap(entry->path) :
+		                        prepare_engine_sample(entry->path, 0);
+		if (!keymap)
+			continue;
+
+		struct keymap* previous = bank->presets[entry->program];
+		bank->presets[entry->program] = keymap;
+		const size_t bytes = keymaps_bytes(bank->presets, BANK_PROGRAMS);
+		if (budget && bytes > budget) {
+			fprintf(stderr,
+			        "WARN: %s goes over the memory limit, skipping\n",
+			        entry->path);
+			bank->presets[entry->program] = previous;
+			free_engine_keymap(keymap);
+		} else {
+			free_engine_keymap(previous);
+			bank->bytes = bytes;
+		}
+	}
+	free_bank_entries(entries, entry_cnt);
+	return bank;
+}
+
+void free_engine_parts(struct engine_parts* parts)
+{
+	if (!parts)
+		return;
+	for (size_t i = 0; i < ENGINE_CHANNELS; i++)
+		free_engine_keymap(parts->keymaps[i]);
+	free(parts);
+}
+
+struct engine_parts* prepare_engine_parts(const struct part_entry* entries)
+{
+	struct engine_parts* parts =
+	        (struct engine_parts*)calloc(1, sizeof(struct engine_parts));
+	if (!parts)
+		return NULL;
+	for (size_t i = 0; i < ENGINE_CHANNELS; i++) {
+		const struct part_entry* entry = &entries[i];
+		if (!entry->path)
+			continue;
+		parts->keymaps[i] = entry->is_keymap ?
+		                    prepare_engine_keymap(entry->path) :
+		                    prepare_engine_sample(entry->path, 0);
+		if (!parts->keymaps[i])
+			fprintf(stderr,
+			        "WARN: channel %zu falls back to the loose sample\n",
+			        i + 1);
+	}
+	parts->bytes = keymaps_bytes(parts->keymaps, ENGINE_CHANNELS);
+	return parts;
+}
+
+static inline void point_at_keymap(struct engine* engine,
+                                   struct keymap* keymap)
+{
+	__atomic_store_n(&engine->keymap, keymap, __ATOMIC_RELEASE);
+}
+
+// playing notes finish on the sample they started with, even once the
+// keymap it came from is gone
+static void hold_voice_samples(struct engine* engine)
+{
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct voice* voice = &engine->voices[i];
+		if (voice->active && !voice->holds_sample) {
+			retain_sample(voice->sample);
+			voice->holds_sample = true;
+		}
+	}
+}
+
+// a sample the loose keymap shares with the bank counts twice here, the
+// exact figure is too slow for the audio thread
+static void update_memory(struct engine* engine)
+{
+	const size_t loose = (engine->loose_keymap ?
+	                      engine->loose_keymap->bytes : 0) +
+	                     (engine->parts ? engine->parts->bytes : 0) +
+	                     (engine->render_cache ?
+	                      engine->render_cache->bytes : 0);
+	engine->memory_bytes = loose + (engine->bank ? engine->bank->bytes : 0);
+
+	size_t budget = 0;
+	if (engine->memory_limit)
+		budget = engine->memory_limit > loose ?
+		         engine->memory_limit - loose : 1;
+	__atomic_store_n(&engine->bank_budget, budget, __ATOMIC_RELAXED);
+}
+
+size_t get_engine_bank_budget(struct engine* engine)
+{
+	return __atomic_load_n(&engine->bank_budget, __ATOMIC_RELAXED);
+}
+
+struct keymap* swap_engine_keymap(struct engine* engine,
+                                  struct keymap* keymap)
+{
+	hold_voice_samples(engine);
+	point_at_keymap(engine, keymap);
+	struct keymap* old = engine->loose_keymap;
+	engine->loose_keymap = keymap;
+	engine->program = NO_PROGRAM;
+	update_memory(engine);
+	return old;
+}
+
+struct engine_bank* swap_engine_bank(struct engine* engine,
+                                     struct engine_bank* bank)
+{
+	hold_voice_samples(engine);
+	struct keymap* current = engine->loose_keymap;
+	if (engine->program != NO_PROGRAM && bank->presets[engine->program])
+		current = bank->presets[engine->program];
+	else
+		engine->program = NO_PROGRAM;
+	point_at_keymap(engine, current);
+	struct engine_bank* old = engine->bank;
+	engine->bank = bank;
+	update_memory(engine);
+	return old;
+}
+
+struct engine_parts* swap_engine_parts(struct engine* engine,
+                                       struct engine_parts* parts)
+{
+	hold_voice_samples(engine);
+	struct engine_parts* old = engine->parts;
+	engine->parts = parts;
+	update_memory(engine);
+	return old;
+}
+
+void free_engine_render_cache(struct engine_render_cache* cache)
+{
+	if (!cache)
+		return;
+	free(cache->audio);
+	free(cache->next_chunk);
+	free(cache);
+}
+
+static size_t render_chunk_doubles(const uint32_t period_frames)
+{
+	return (size_t)RENDER_CHUNK_PERIODS * period_frames * MAX_OUTS;
+}
+
+struct engine_render_cache*
+prepare_engine_render_cache(const size_t bytes, const uint32_t period_frames)
+{
+	const size_t chunk_bytes = sizeof(double) *
+	                           render_chunk_doubles(period_frames);
+	size_t chunk_cnt = bytes / chunk_bytes;
+	if (chunk_cnt == 0)
+		return NULL;
+	if (chunk_cnt >= NO_CHUNK)
+		chunk_cnt = NO_CHUNK - 1;
+
+	struct engine_render_cache* cache = (struct engine_render_cache*)
+	        calloc(1, sizeof(struct engine_render_cache));
+	if (!cache)
+		return NULL;
+	cache->period_frames = period_frames;
+	cache->chunk_cnt = chunk_cnt;
+	// written through here so that the pages are in before the audio
+	// thread records into them
+	cache->audio = (double*)malloc(chunk_bytes * chunk_cnt);
+	cache->next_chunk = (uint32_t*)malloc(sizeof(uint32_t) * chunk_cnt);
+	if (!cache->audio || !cache->next_chunk) {
+		free_engine_render_cache(cache);
+		return NULL;
+	}
+	memset(cache->audio, '\0', chunk_bytes * chunk_cnt);
+	for (uint32_t i = 0; i < chunk_cnt; i++)
+		cache->next_chunk[i] = i + 1 < chunk_cnt ? i + 1 : NO_CHUNK;
+	cache->free_chunk = 0;
+	cache->bytes = chunk_bytes * chunk_cnt +
+	               sizeof(uint32_t) * chunk_cnt +
+	               sizeof(struct engine_render_cache);
+	return cache;
+}
+
+// voices playing back from the old cache carry on with their streams,
+// and a recording is cut short
+struct engine_render_cache*
+swap_engine_render_cache(struct engine* engine,
+                         struct engine_render_cache* cache)
+{
+	for (size_t i = 0; i < MAX_POLY; i++)
+		engine->voices[i].render = NO_RENDER;
+	struct engine_render_cache* old = engine->render_cache;
+	engine->render_cache = cache;
+	update_memory(engine);
+	return old;
+}
+
+bool select_engine_preset(struct engine* engine, const unsigned program)
+{
+	if (program >= BANK_PROGRAMS ||
+	    !engine->bank ||
+	    !engine->bank->presets[program])
+		return false;
+	if ((int)program == engine->program)
+		return true;
+	point_at_keymap(engine, engine->bank->presets[program]);
+	engine->program = program;
+	return true;
+}
+
+size_t get_engine_memory(struct engine* engine)
+{
+	return engine->memory_bytes;
+}
+
+void set_engine_memory_limit(struct engine* engine, const size_t bytes)
+{
+	if (engine->memory_limit == bytes)
+		return;
+	engine->memory_limit = bytes;
+	update_memory(engine);
+}
+
+void destroy_engine(struct engine* engine)
+{
+	for (size_t i = 0; i < MAX_POLY; i++)
+		for (size_t j = 0; j < STREAMS; j++)
+			free_stream(&engine->voices[i].streams[j]);
+	destroy_vochorus_pool(engine->pool);
+	export_vochorus_wisdom();
+	for (size_t i = 0; i < MAX_POLY; i++)
+		if (engine->voices[i].holds_sample)
+			release_sample(engine->voices[i].sample);
+	release_engine_retired(engine);
+	free_engine_keymap(engine->loose_keymap);
+	free_engine_bank(engine->bank);
+	free_engine_parts(engine->parts);
+	free_engine_render_cache(engine->render_cache);
+	free(engine->seek_points);
+	for (size_t i = 0; i < MAX_OUTS; i++)
+		free(engine->mix[i]);
+	free(engine);
+}
+
+static double envelope_curve(const double t, const double shape)
+{
+	if (shape == 0)
+		return t;
+	return (1 - exp(t * shape)) / (1 - exp(shape));
+}
+
+static void begin_segment(struct envelope* env,
+                          const enum envelope_stage stage,
+                          const double target,
+                          const double time,
+                          const double shape,
+                          const double sample_rate)
+{
+	env->stage = stage;
+	env->start = env->value;
+	env->target = target;
+	env->shape = shape;
+	env->pos = 0;
+	env->len = time > 0 ? (uint64_t)llround(time * sample_rate) : 0;
+}
+
+static void next_segment(struct envelope* env, const double sample_rate)
+{
+	env->value = env->target;
+	if (env->stage == ENV_ATTACK)
+		begin_segment(env,
+		              ENV_DECAY,
+		              env->sustain_level,
+		              env->decay_time,
+		              env->decay_shape,
+		              sample_rate);
+	else if (env->stage == ENV_DECAY)
+		env->stage = ENV_SUSTAIN;
+	else if (env->stage == ENV_RELEASE)
+		env->stage = ENV_DONE;
+}
+
+static double tick_envelope(struct envelope* env, const double sample_rate)
+{
+	while ((env->stage == ENV_ATTACK ||
+	        env->stage == ENV_DECAY  ||
+	        env->stage == ENV_RELEASE) && env->pos >= env->len)
+		next_segment(env, sample_rate);
+
+	if (env->stage == ENV_SUSTAIN || env->stage == ENV_DONE)
+		return env->value;
+
+	env->value = env->start + (env->target - env->start) *
+	             envelope_curve((double)env->pos / env->len, env->shape);
+	env->pos++;
+	return env->value;
+}
+
+static void start_envelope(struct envelope* env,
+                           const struct engine_settings* s,
+                           const double sample_rate)
+{
+	env->value = 0;
+	env->decay_time = s->env_decay_time;
+	env->decay_shape = s->env_decay_shape;
+	env->sustain_level = s->env_sustain_level;
+	env->release_time = s->env_release_time;
+	env->release_shape = s->env_release_shape;
+	begin_segment(env,
+	              ENV_ATTACK,
+	              1,
+	              s->env_attack_time,
+	              s->env_attack_shape,
+	              sample_rate);
+}
+
+static void release_envelope(struct envelope* env, const double sample_rate)
+{
+	begin_segment(env,
+	              ENV_RELEASE,
+	              0,
+	              env->release_time,
+	              env->release_shape,
+	              sample_rate);
+}
+
+// 0 when a note can't come out the same twice: a free running vibrato,
+// a bend or a slide make it depend on more than its own settings
+static uint64_t render_key(const struct engine_sample* sample,
+                           const uint8_t note,
+                           const struct engine_settings* s,
+                           const struct engine_expression* expression)
+{
+	if (s->vibrato_amp > 0 && s->vibrato_retrigger != 1)
+		return 0;
+	if (expression->pitch != 1 || expression->speed != 1)
+		return 0;
+
+	// what only shapes the mixed streams afterwards stays out of it
+	struct engine_settings streams = *s;
+	streams.env_attack_time   = 0;
+	streams.env_attack_shape  = 0;
+	streams.env_decay_time    = 0;
+	streams.env_decay_shape   = 0;
+	streams.env_sustain_level = 0;
+	streams.env_release_time  = 0;
+	streams.env_release_shape = 0;
+	streams.note_pan_center   = 0;
+	streams.note_pan_amt      = 0;
+	streams.max_polyphony     = 0;
+	uint64_t key = hash_bytes(sample->hash, &note, sizeof(note));
+	key = hash_bytes(key, &streams, sizeof(streams));
+	return key ? key : 1;
+}
+
+static struct render_entry* find_render(struct engine_render_cache* cache,
+                                        const uint64_t key)
+{
+	for (size_t i = 0; i < RENDER_ENTRIES; i++)
+		if (cache->entries[i].used && cache->entries[i].key == key)
+			return &cache->entries[i];
+	return NULL;
+}
+
+// an unused slot first, or else the least recently started entry that no
+// voice is playing
+static struct render_entry* spare_render(struct engine_render_cache* cache)
+{
+	struct render_entry* spare = NULL;
+	for (size_t i = 0; i < RENDER_ENTRIES; i++) {
+		struct render_entry* entry = &cache->entries[i];
+		if (!entry->used)
+			return entry;
+		if (entry->players == 0 &&
+		    (!spare || entry->last_used < spare->last_used))
+			spare = entry;
+	}
+	return spare;
+}
+
+static void evict_render(struct engine_render_cache* cache,
+                         struct render_entry* entry)
+{
+	if (entry->first_chunk != NO_CHUNK) {
+		cache->next_chunk[entry->last_chunk] = cache->free_chunk;
+		cache->free_chunk = entry->first_chunk;
+	}
+	entry->used = false;
+}
+
+static uint32_t take_render_chunk(struct engine_render_cache* cache)
+{
+	while (cache->free_chunk == NO_CHUNK) {
+		struct render_entry* spare = spare_render(cache);
+		if (!spare || !spare->used)
+			return NO_CHUNK;
+		evict_render(cache, spare);
+	}
+	const uint32_t chunk = cache->free_chunk;
+	cache->free_chunk = cache->next_chunk[chunk];
+	cache->next_chunk[chunk] = NO_CHUNK;
+	return chunk;
+}
+
+static double* render_audio(const struct engine_render_cache* cache,
+                            const uint32_t chunk,
+                            const size_t period)
+{
+	return &cache->audio[chunk * render_chunk_doubles(cache->period_frames) +
+	                     (period % RENDER_CHUNK_PERIODS) *
+	                     cache->period_frames * MAX_OUTS];
+}
+
+// a hit plays back and a miss records, but an entry that another voice
+// is still recording is left to it
+static void attach_render(struct engine* engine,
+                          struct voice* voice,
+                          const struct engine_settings* s,
+                          const struct engine_expression* expression)
+{
+	voice->render = NO_RENDER;
+	struct engine_render_cache* cache = engine->render_cache;
+	if (!cache || cache->period_frames != engine->ksmps)
+		return;
+	const uint64_t key = render_key(voice->sample, voice->note, s, expression);
+	if (key == 0)
+		return;
+
+	struct render_entry* entry = find_render(cache, key);
+	if (entry && entry->recording)
+		return;
+	if (!entry) {
+		entry = spare_render(cache);
+		if (!entry)
+			return;
+		if (entry->used)
+			evict_render(cache, entry);
+		*entry = (struct render_entry){
+			.used        = true,
+			.recording   = true,
+			.key         = key,
+			.first_chunk = NO_CHUNK,
+			.last_chunk  = NO_CHUNK
+		};
+	}
+	entry->players++;
+	entry->last_used = ++cache->clock;
+	voice->render = entry - cache->entries;
+	voice->replaying = !entry->recording;
+	voice->render_key = key;
+	voice->render_period = 0;
+	voice->render_chunk = entry->first_chunk;
+}
+
+static void detach_render(struct engine* engine, struct voice* voice)
+{
+	if (voice->render == NO_RENDER)
+		return;
+	struct engine_render_cache* cache = engine->render_cache;
+	struct render_entry* entry = &cache->entries[voice->render];
+	entry->players--;
+	if (entry->recording) {
+		entry->recording = false;
+		if (entry->periods == 0)
+			evict_render(cache, entry);
+	}
+	voice->render = NO_RENDER;
+}
+
+// the period the voice is at in its entry, stepping on to the next
+// chunk as it crosses into one
+static const double* replay_audio(struct engine_render_cache* cache,
+                                  struct voice* voice)
+{
+	if (voice->render_period > 0 &&
+	    voice->render_period % RENDER_CHUNK_PERIODS == 0)
+		voice->render_chunk = cache->next_chunk[voice->render_chunk];
+	return render_audio(cache, voice->render_chunk, voice->render_period);
+}
+
+// the next period from the cache while the note is still the one that
+// was recorded, short of the last one, which hand_over_render plays
+// under the streams taking over
+static bool replay_render(struct engine* engine,
+                          struct voice* voice,
+                          const uint64_t key)
+{
+	if (voice->render == NO_RENDER || !voice->replaying)
+		return false;
+	struct engine_render_cache* cache = engine->render_cache;
+	const struct render_entry* entry = &cache->entries[voice->render];
+	if (key != voice->render_key ||
+	    voice->render_period + 1 >= entry->periods)
+		return false;
+
+	const double* audio = replay_audio(cache, voice);
+	for (size_t i = 0; i < MAX_OUTS; i++)
+		memcpy(engine->mix[i],
+		       &audio[i * engine->ksmps],
+		       sizeof(double) * engine->ksmps);
+	voice->render_period++;
+	return true;
+}
+
+// the streams start with fresh phases, so a replay that runs out or
+// whose note changes fades from its cached period over to them rather
+// than cutting across
+static void hand_over_render(struct engine* engine, struct voice* voice)
+{
+	if (voice->render == NO_RENDER || !voice->replaying)
+		return;
+	struct engine_render_cache* cache = engine->render_cache;
+	const struct render_entry* entry = &cache->entries[voice->render];
+	if (voice->render_period < entry->periods) {
+		const double* audio = replay_audio(cache, voice);
+		const double step = 1.0 / engine->ksmps;
+		for (size_t i = 0; i < MAX_OUTS; i++) {
+			const double* cached = &audio[i * engine->ksmps];
+			double* const mix = engine->mix[i];
+			for (size_t n = 0; n < engine->ksmps; n++)
+				mix[n] = cached[n] +
+				         (mix[n] - cached[n]) * (n + 1) * step;
+		}
+	}
+	detach_render(engine, voice);
+}
+
+static void record_render(struct engine* engine,
+                          struct voice* voice,
+                          const uint64_t key)
+{
+	if (voice->render == NO_RENDER || voice->replaying)
+		return;
+	struct engine_render_cache* cache = engine->render_cache;
+	struct render_entry* entry = &cache->entries[voice->render];
+	if (key != voice->render_key) {
+		detach_render(engine, voice);
+		return;
+	}
+
+	if (entry->periods % RENDER_CHUNK_PERIODS == 0) {
+		const uint32_t chunk = take_render_chunk(cache);
+		if (chunk == NO_CHUNK) {
+			detach_render(engine, voice);
+			return;
+		}
+		if (entry->last_chunk == NO_CHUNK)
+			entry->first_chunk = chunk;
+		else
+			cache->next_chunk[entry->last_chunk] = chunk;
+		entry->last_chunk = chunk;
+	}
+	double* audio = render_audio(cache, entry->last_chunk, entry->periods);
+	for (size_t i = 0; i < MAX_OUTS; i++)
+		memcpy(&audio[i * engine->ksmps],
+		       engine->mix[i],
+		       sizeof(double) * engine->ksmps);
+	entry->periods++;
+}
+
+static bool start_stream(struct engine* engine,
+                         struct stream* stream,
+                         const struct engine_settings* s,
+                         const bool low_latency)
+{
+	struct vochorus* const chorus = &stream->chorus;
+	set_vochorus_size(chorus, s->fft_size, s->fft_overlap);
+	return start_vochorus(chorus,
+	                      engine->pool,
+	                      MAX_OUTS,
+	                      low_latency,
+	                      s->interpolation);
+}
+
+static bool start_voice_streams(struct engine* engine,
+                                struct voice* voice,
+                                const struct engine_settings* s,
+                                const bool low_latency)
+{
+	for (size_t i = 0; i < voice->stream_cnt; i++) {
+		if (!start_stream(engine, &voice->streams[i], s, low_latency)) {
+			for (size_t j = 0; j < i; j++)
+				stop_vochorus(&voice->streams[j].chorus);
+			return false;
+		}
+	}
+	voice->streams_started = true;
+	return true;
+}
+
+static void end_voice(struct engine* engine, struct voice* voice)
+{
+	detach_render(engine, voice);
+	for (size_t i = 0; i < voice->stream_cnt; i++)
+		stop_vochorus(&voice->streams[i].chorus);
+	if (voice->holds_sample) {
+		retire_sample(engine, voice->sample);
+		voice->holds_sample = false;
+	}
+	voice->active = false;
+}
+
+static struct engine_sample* pick_zone(struct engine* engine,
+                                       const uint8_t channel,
+                                       const uint8_t note,
+                                       const uint8_t velocity)
+{
+	struct keymap* keymap = engine->parts ?
+	                        engine->parts->keymaps[channel] : NULL;
+	if (!keymap)
+		keymap = __atomic_load_n(&engine->keymap, __ATOMIC_ACQUIRE);
+	if (!keymap)
+		return NULL;
+
+	const uint8_t index = keymap->lookup[note][velocity];
+	if (index == NO_ZONE_GROUP)
+		return NULL;
+
+	struct zone_group* group = &keymap->groups[index];
+	if (group->zone_cnt == 0)
+		return NULL;
+	const uint8_t zone = group->zones[group->next];
+	group->next = (group->next + 1) % group->zone_cnt;
+	return keymap->samples[zone];
+}
+
+static unsigned active_voices(const struct engine* engine)
+{
+	unsigned count = 0;
+	for (size_t i = 0; i < MAX_POLY; i++)
+		if (engine->voices[i].active)
+			count++;
+	return count;
+}
+
+void start_note(struct engine* engine,
+                const struct engine_settings* s,
+                const uint8_t channel,
+                const uint8_t note,
+                const uint8_t velocity)
+{
+	struct engine_sample* sample = pick_zone(engine,
+	                                         channel % ENGINE_CHANNELS,
+	                                         note & 0x7f,
+	                                         velocity & 0x7f);
+	if (!sample)
+		return;
+	if (s->max_polyphony > 0 && active_voices(engine) >= s->max_polyphony)
+		return;
+
+	size_t index = 0;
+	while (index < MAX_POLY && engine->voices[index].active)
+		index++;
+	if (index == MAX_POLY) {
+		__atomic_fetch_add(&engine->dropped_notes, 1, __ATOMIC_RELAXED);
+		return;
+	}
+	struct voice* voice = &engine->voices[index];
+
+	voice->sample = sample;
+	voice->holds_sample = false;
+	voice->channel = channel % ENGINE_CHANNELS;
+	voice->note = note;
+	voice->stream_cnt = sample->stereo ? 2 : 1;
+	voice->streams_started = false;
+	attach_render(engine,
+	              voice,
+	              s,
+	              &engine->channel_expression[voice->channel]);
+	const bool replaying = voice->render != NO_RENDER && voice->replaying;
+	if (!replaying &&
+	    !start_voice_streams(engine, voice, s, s->low_latency != 0)) {
+		detach_render(engine, voice);
+		return;
+	}
+	// a note standing in at the FFT size the pool had is no recording
+	// for the notes after it
+	if (!replaying && voice->streams[0].chorus.stand_in)
+		detach_render(engine, voice);
+
+	voice->active = true;
+	voice->note_off = false;
+	voice->stop = false;
+	voice->main_loop_times = s->loop_times;
+	voice->release_loop_times = s->release_loop_times;
+	voice->sus_main_loop_limit = s->loop_times + 1;
+	voice->main_loops = 0;
+	voice->release_loops = 0;
+	voice->dialdown = 1;
+	voice->vib_offset = engine->vib_phase;
+	// MPE controllers send a note's bend and pressure ahead of it
+	engine->expression[index] = engine->channel_expression[voice->channel];
+	voice->gain = engine->expression[index].gain;
+	memset(&voice->phasors, '\0', sizeof(struct voice_phasors));
+	start_envelope(&voice->env, s, engine->sample_rate);
+}
+
+void release_note(struct engine* engine,
+                  const uint8_t channel,
+                  const uint8_t note)
+{
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct voice* voice = &engine->voices[i];
+		if (voice->active && !voice->note_off &&
+		    voice->channel == channel && voice->note == note) {
+			voice->note_off = true;
+			release_envelope(&voice->env, engine->sample_rate);
+		}
+	}
+}
+
+void express_channel(struct engine* engine,
+                     const uint8_t channel,
+                     const struct engine_expression* expression)
+{
+	engine->channel_expression[channel] = *expression;
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		const struct voice* voice = &engine->voices[i];
+		if (!voice->active || voice->channel != channel)
+			continue;
+		// a released note keeps the level it was let go at, rather
+		// than following the pressure of whatever plays next
+		const double gain = engine->expression[i].gain;
+		engine->expression[i] = *expression;
+		if (voice->note_off)
+			engine->expression[i].gain = gain;
+	}
+}
+
+void silence_engine(struct engine* engine)
+{
+	for (size_t i = 0; i < MAX_POLY; i++)
+		if (engine->voices[i].active)
+			end_voice(engine, &engine->voices[i]);
+}
+
+static bool phase_over(const double loops,
+                       const double loop_times,
+                       const double early)
+{
+	return loop_times > 0 && loops >= loop_times - early;
+}
+
+static bool in_sustain_phase(const struct voice* voice,
+                             const struct engine_settings* s,
+                             const bool released)
+{
+	return s->sustain_section == 1 &&
+	       voice->main_loops >= voice->sus_main_loop_limit &&
+	       !released;
+}
+
+static double loops_per_period(const struct engine* engine,
+                               const struct voice* voice,
+                               const double start,
+                               const double end,
+                               const double speed)
+{
+	return (1 / (voice->sample->dur * (end - start) / speed)) / engine->kr;
+}
+
+struct breakpoint {
+	double pos;
+	double value;
+};
+
+// giwacky's GEN07 segments, with the positions over the table length
+static const struct breakpoint wacky_shape[] = {
+	{      0 / 131072.0,  0         },
+	{  10662 / 131072.0, -0.695541  },
+	{  17428 / 131072.0,  0.624639  },
+	{  25062 / 131072.0, -0.217517  },
+	{  37358 / 131072.0,  0.894129  },
+	{  42524 / 131072.0,  0.210780  },
+	{  53860 / 131072.0,  0.318255  },
+	{  57654 / 131072.0, -0.677895  },
+	{  92438 / 131072.0,  0.791466  },
+	{  98426 / 131072.0, -0.456529  },
+	{ 105830 / 131072.0, -0.179018  },
+	{ 108070 / 131072.0, -0.769329  },
+	{ 126400 / 131072.0,  0.340712  },
+	{ 131074 / 131072.0,  0         }
+};
+
+static double breakpoint_value(const struct breakpoint* points,
+                               const size_t count,
+                               const double pos)
+{
+	for (size_t i = 1; i < count; i++) {
+		if (pos < points[i].pos) {
+			const struct breakpoint* from = &points[i - 1];
+			const struct breakpoint* to = &points[i];
+			return from->value + (to->value - from->value) *
+			       (pos - from->pos) / (to->pos - from->pos);
+		}
+	}
+	return points[count - 1].value;
+}
+
+static double vibrato_shape(const unsigned waveform, const double phase)
+{
+	if (waveform == VIB_TRIANGLE)
+		return phase < 0.5 ? 4 * phase - 1 : 3 - 4 * phase;
+	else if (waveform == VIB_SQUARE)
+		return phase < 0.5 ? 1 : -1;
+	else if (waveform == VIB_WACKY)
+		return breakpoint_value(wacky_shape,
+		                        sizeof(wacky_shape) /
+		                        sizeof(struct breakpoint),
+		                        phase);
+	else
+		return sin(2 * M_PI * phase);
+}
+
+static inline double wrap_phase(const double phase)
+{
+	return phase - floor(phase);
+}
+
+// one lfo for every voice, stepped once per control period
+static void run_vibrato(struct engine* engine,
+                        const struct engine_settings* s)
+{
+	if (!(s->vibrato_amp > 0))
+		return;
+
+	double freq;
+	if (s->vibrato_tempo_toggle == 1)
+		freq = s->vibrato_tempo_fraction * s->bps;
+	else
+		freq = s->vibrato_freq;
+
+	engine->vib_phase = wrap_phase(engine->vib_phase + freq / engine->kr);
+	engine->vib = vibrato_shape(s->vibrato_waveform_type,
+	                            engine->vib_phase) *
+	              s->vibrato_amp;
+}
+
+// voices that retrigger read the shared lfo from where it was at note on
+static double voice_vibrato(const struct engine* engine,
+                            const struct voice* voice,
+                            const struct engine_settings* s)
+{
+	if (!(s->vibrato_amp > 0))
+		return 0;
+	if (s->vibrato_retrigger != 1)
+		return engine->vib;
+
+	return vibrato_shape(s->vibrato_waveform_type,
+	                     wrap_phase(engine->vib_phase - voice->vib_offset)) *
+	       s->vibrato_amp;
+}
+
+static double note_pan(const struct voice* voice,
+                       const struct engine_settings* s)
+{
+	double pan;
+	if (s->note_pan_amt == 0)
+		pan = 0.5;
+	else
+		pan = ((voice->note - s->note_pan_center) /
+		       (NOTE_PAN_RANGE * (1 / s->note_pan_amt))) + 0.5;
+
+	if (pan < 0)
+		pan = 0;
+	else if (pan > 1)
+		pan = 1;
+	return pan;
+}
+
+static void fill_seek_points(struct engine* engine,
+                             struct voice* voice,
+                             const struct engine_settings* s,
+                             const bool released,
+                             const double speed)
+{
+	const double dur = voice->sample->dur;
+	const double rate = speed / dur;
+
+	double* phasor;
+	double start;
+	double end;
+	if (released) {
+		phasor = &voice->phasors.release;
+		start = s->tie_release_start_to_main_end == 1 ?
+		        s->end_point : s->release_start_point;
+		end = s->release_end_point;
+	}
+	else if (in_sustain_phase(voice, s, released)) {
+		phasor = &voice->phasors.sustain;
+		start = s->sustain_start_point;
+		end = s->tie_sustain_end_to_main_end == 1 ?
+		      s->end_point : s->sustain_end_point;
+	}
+	else if (s->start_point > 0 || s->end_point < 1) {
+		phasor = &voice->phasors.main;
+		start = s->start_point;
+		end = s->end_point;
+	}
+	else {
+		phasor = &voice->phasors.full;
+		start = 0;
+		end = 1;
+	}
+
+	const double len = end - start;
+	const double incr = rate * (1 / len) / engine->sample_rate;
+	double phase = *phasor;
+	for (size_t n = 0; n < engine->ksmps; n++) {
+		const double pointer = phase * len + start;
+		if (s->reverse == 1)
+			engine->seek_points[n] = fabs(pointer - 0.9) * dur;
+		else
+			engine->seek_points[n] = pointer * dur;
+		phase = wrap_phase(phase + incr);
+	}
+	*phasor = phase;
+}
+
+static void run_streams(struct engine* engine,
+                        struct voice* voice,
+                        const struct engine_settings* s,
+                        const double pitch)
+{
+	struct vochorus_input input;
+	input.sample_len    = voice->sample->len;
+	input.sample_rate   = voice->sample->sample_rate;
+	input.pitch         = pitch;
+	input.chorus_voices = s->chorus_voices;
+	input.mix           = s->chorus_mix;
+	input.detune        = s->chorus_detune;
+	input.spread        = s->chorus_spread;
+	input.onsets        = s->preserve_transients == 1 ?
+	                      voice->sample->onsets : NULL;
+	input.onset_cnt     = s->preserve_transients == 1 ?
+	                      voice->sample->onset_cnt : 0;
+	input.envelopes     = s->preserve_formants == 1 ?
+	                      voice->sample->envelopes : NULL;
+	input.envelope_cnt  = s->preserve_formants == 1 ?
+	                      voice->sample->envelope_cnt : 0;
+
+	for (size_t i = 0; i < voice->stream_cnt; i++) {
+		struct stream* stream = &voice->streams[i];
+		if (voice->stream_cnt == 1) {
+			input.sample = voice->sample->left;
+			input.main_channel_pan = BOTH_CHANNELS;
+		}
+		else {
+			input.sample = i == 0 ? voice->sample->left :
+			                        voice->sample->right;
+			input.main_channel_pan = i == 0 ? LEFT_ONLY : RIGHT_ONLY;
+		}
+		set_vochorus_input(&stream->chorus, &input, engine->sample_rate);
+		run_vochorus(&stream->chorus,
+		             engine->seek_points,
+		             stream->out,
+		             0,
+		             engine->ksmps);
+	}
+}
+
+static void mix_streams(struct engine* engine, const struct voice* voice)
+{
+	for (size_t n = 0; n < engine->ksmps; n++) {
+		double sig_l = 0;
+		double sig_r = 0;
+		for (size_t i = 0; i < voice->stream_cnt; i++) {
+			sig_l += voice->streams[i].out[0][n];
+			sig_r += voice->streams[i].out[1][n];
+		}
+		engine->mix[0][n] = sig_l;
+		engine->mix[1][n] = sig_r;
+	}
+}
+
+static void run_voice(struct engine* engine,
+                      struct voice* voice,
+                      const struct engine_settings* s,
+                      const struct channel_ratios* ratios,
+                      const struct engine_expression* expression,
+                      double* out_l,
+                      double* out_r)
+{
+	const bool sustain_on = s->sustain_section == 1;
+	const bool release_on = s->release_section == 1;
+
+	const double vib = voice_vibrato(engine, voice, s);
+
+	bool released;
+	if (phase_over(voice->main_loops, voice->main_loop_times, 0) &&
+	    !sustain_on && release_on)
+		released = true;
+	else
+		released = voice->note_off;
+
+	const double speed = ratios->speed.ratios[voice->note] *
+	                     expression->speed;
+	const double pitch = ratios->pitch.ratios[voice->note];
+
+	if (released) {
+		if (release_on) {
+			const double release_start =
+			        s->tie_release_start_to_main_end == 1 ?
+			        s->end_point : s->release_start_point;
+			voice->release_loops +=
+			        loops_per_period(engine,
+			                         voice,
+			                         release_start,
+			                         s->release_end_point,
+			                         speed);
+		}
+		else {
+			voice->stop = true;
+		}
+	}
+	else if (!in_sustain_phase(voice, s, released)) {
+		voice->main_loops += loops_per_period(engine,
+		                                      voice,
+		                                      s->start_point,
+		                                      s->end_point,
+		                                      speed);
+	}
+
+	fill_seek_points(engine, voice, s, released, speed);
+	// a release depends on when the note off came, so it's never cached
+	const uint64_t key = voice->render == NO_RENDER || released ? 0 :
+	                     render_key(voice->sample, voice->note, s, expression);
+	if (!replay_render(engine, voice, key)) {
+		// taking over from a replay, the preroll stands in for the
+		// frames the streams never ran
+		if (!voice->streams_started &&
+		    !start_voice_streams(engine, voice, s, true)) {
+			end_voice(engine, voice);
+			return;
+		}
+		run_streams(engine, voice, s, (pitch + vib) * expression->pitch);
+		mix_streams(engine, voice);
+		hand_over_render(engine, voice);
+		record_render(engine, voice, key);
+	}
+
+	const double pan = note_pan(voice, s);
+	const double pan_l = cos(pan * M_PI_2);
+	const double pan_r = sin(pan * M_PI_2);
+
+	if ((phase_over(voice->main_loops, voice->main_loop_times, 0.1) &&
+	     !release_on && !sustain_on) ||
+	    phase_over(voice->release_loops, voice->release_loop_times, 0.1))
+		voice->stop = true;
+
+	double dialdown = 1;
+	if (voice->stop) {
+		voice->dialdown -= DIALDOWN_STEP;
+		if (voice->dialdown < 0)
+			voice->dialdown = 0;
+		dialdown = voice->dialdown;
+	}
+
+	// pressure moves in steps of a control period, so it is ramped to
+	// keep it from clicking
+	double gain = voice->gain;
+	const double gain_step = (expression->gain - gain) / engine->ksmps;
+	voice->gain = expression->gain;
+
+	for (size_t n = 0; n < engine->ksmps; n++) {
+		const double env = tick_envelope(&voice->env, engine->sample_rate) *
+		                   gain;
+		gain += gain_step;
+		out_l[n] += engine->mix[0][n] * env * pan_l * dialdown;
+		out_r[n] += engine->mix[1][n] * env * pan_r * dialdown;
+	}
+
+	// the instrument would keep running silently until its release is
+	// over, but there's nothing left to hear
+	if (voice->env.stage == ENV_DONE || (voice->stop && dialdown == 0))
+		end_voice(engine, voice);
+}
+
+static void update_ratios(struct channel_ratios* ratios,
+                          const struct engine_settings* s)
+{
+	const struct vocparam_settings speed = {
+		.adjust          = s->speed_adjust,
+		.center          = s->speed_center,
+		.lower_scale_pos = s->speed_lower_scale,
+		.upper_scale_pos = s->speed_upper_scale
+	};
+	const struct vocparam_settings pitch = {
+		.adjust          = s->pitch_adjust,
+		.center          = s->pitch_center,
+		.lower_scale_pos = s->pitch_lower_scale,
+		.upper_scale_pos = s->pitch_upper_scale
+	};
+	update_vocparam_table(&ratios->speed, &speed);
+	update_vocparam_table(&ratios->pitch, &pitch);
+}
+
+void run_engine(struct engine* engine,
+                const struct engine_settings* settings,
+                const struct engine_settings* const* channel_settings,
+                double* out_l,
+                double* out_r)
+{
+	memset(out_l, '\0', sizeof(double) * engine->ksmps);
+	memset(out_r, '\0', sizeof(double) * engine->ksmps);
+
+	run_vibrato(engine, settings);
+	update_ratios(&engine->ratios, settings);
+	for (size_t c = 0; c < ENGINE_CHANNELS; c++)
+		if (channel_settings[c] != settings)
+			update_ratios(&engine->part_ratios[c], channel_settings[c]);
+
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct voice* voice = &engine->voices[i];
+		if (!voice->active)
+			continue;
+		const struct engine_settings* s = channel_settings[voice->channel];
+		run_voice(engine,
+		          voice,
+		          s,
+		          s == settings ? &engine->ratios :
+		                          &engine->part_ratios[voice->channel],
+		          &engine->expression[i],
+		          out_l,
+		          out_r);
+	}
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef c93e5a17f04b4d62a8b1e7d3f5c2a690
+#define c93e5a17f04b4d62a8b1e7d3f5c2a690
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// the same per-note behavior as instr 2 in warpy.orc.erb, in C
+
+struct engine;
+struct keymap;
+struct engine_bank;
+struct engine_parts;
+struct engine_render_cache;
+struct part_entry;
+
+#define ENGINE_CHANNELS 16
+
+// what the orchestra reads from its channels, already through the calc
+// functions in warpy.c
+struct engine_settings {
+	double bps;
+	double speed_adjust;
+	double speed_center;
+	double speed_lower_scale;
+	double speed_upper_scale;
+	double pitch_adjust;
+	double pitch_center;
+	double pitch_lower_scale;
+	double pitch_upper_scale;
+	double env_attack_time;
+	double env_attack_shape;
+	double env_decay_time;
+	double env_decay_shape;
+	double env_sustain_level;
+	double env_release_time;
+	double env_release_shape;
+	double reverse;
+	double loop_times;
+	double start_point;
+	double end_point;
+	double sustain_section;
+	double tie_sustain_end_to_main_end;
+	double sustain_start_point;
+	double sustain_end_point;
+	double release_section;
+	double tie_release_start_to_main_end;
+	double release_start_point;
+	double release_end_point;
+	double release_loop_times;
+	double vibrato_amp;
+	double vibrato_waveform_type;
+	double vibrato_tempo_toggle;
+	double vibrato_freq;
+	double vibrato_tempo_fraction;
+	double vibrato_retrigger;
+	double chorus_voices;
+	double chorus_mix;
+	double chorus_detune;
+	double chorus_spread;
+	double note_pan_center;
+	double note_pan_amt;
+	double fft_size;
+	double fft_overlap;
+	double low_latency;
+	double interpolation;
+	double preserve_transients;
+	double preserve_formants;
+	double max_polyphony;
+};
+
+// per note expression from pitch bend, pressure and slide, as ratios
+// on top of the settings; 1 across the board leaves a note as it is
+struct engine_expression {
+	double pitch;
+	double speed;
+	double gain;
+};
+
+struct engine* create_engine(double sample_rate, uint32_t control_period_frames);
+void destroy_engine(struct engine* engine);
+
+// a path hash is enough to tell samples apart, the identity adds the
+// file's device, inode, size and mtime so that an edit shows up too
+uint64_t hash_sample_path(const char* path);
+uint64_t get_sample_identity(const char* path);
+
+// loading is split in two: the prepare functions decode and touch no
+// engine, so they can run on any thread, and the swap functions are quick
+// enough for the audio thread and hand back what they replaced
+struct keymap* prepare_engine_sample(const char* path, uint64_t hash);
+struct keymap* prepare_engine_keymap(const char* path);
+struct engine_bank* prepare_engine_bank(const char* path, size_t budget);
+struct engine_parts* prepare_engine_parts(const struct part_entry* entries);
+// repeat notes with the same sample, note and settings play back what the
+// first one rendered, up to the note off; 0 bytes gives no cache at all
+struct engine_render_cache*
+prepare_engine_render_cache(size_t bytes, uint32_t period_frames);
+uint64_t get_engine_keymap_hash(const struct keymap* keymap);
+uint64_t get_engine_keymap_identity(const struct keymap* keymap);
+void free_engine_keymap(struct keymap* keymap);
+void free_engine_bank(struct engine_bank* bank);
+void free_engine_parts(struct engine_parts* parts);
+void free_engine_render_cache(struct engine_render_cache* cache);
+struct keymap* swap_engine_keymap(struct engine* engine,
+                                  struct keymap* keymap);
+struct engine_bank* swap_engine_bank(struct engine* engine,
+                                     struct engine_bank* bank);
+struct engine_parts* swap_engine_parts(struct engine* engine,
+                                       struct engine_parts* parts);
+struct engine_render_cache*
+swap_engine_render_cache(struct engine* engine,
+                         struct engine_render_cache* cache);
+
+bool select_engine_preset(struct engine* engine, unsigned program);
+size_t get_engine_memory(struct engine* engine);
+void set_engine_memory_limit(struct engine* engine, size_t bytes);
+size_t get_engine_bank_budget(struct engine* engine);
+// what the audio thread leaves for another one: notes dropped for want
+// of a voice or machinery since the last call, and samples whose last
+// reference a voice let go of, which the release call frees
+size_t take_engine_dropped_notes(struct engine* engine);
+void release_engine_retired(struct engine* engine);
+// off the audio thread, since it replans the FFTs
+void size_engine_machinery(struct engine* engine, double fft_size);
+
+void start_note(struct engine* engine,
+                const struct engine_settings* settings,
+                uint8_t channel,
+                uint8_t note,
+                uint8_t velocity);
+void release_note(struct engine* engine, uint8_t channel, uint8_t note);
+// reaches the notes already playing on the channel and the ones it
+// starts next
+void express_channel(struct engine* engine,
+                     uint8_t channel,
+                     const struct engine_expression* expression);
+void silence_engine(struct engine* engine);
+
+// settings drives everything shared between channels, like the vibrato
+// LFO, and channel_settings has a pointer per channel, which is settings
+// itself for channels without a part
+void run_engine(struct engine* engine,
+                const struct engine_settings* settings,
+                const struct engine_settings* const* channel_settings,
+                double* out_l,
+                double* out_r);
+
+#endif
@@ -0,0 +1,367 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "keymap.h"
+
+#define KEYMAP_LINE_MAX 4096
+#define MIDI_MAX 127
+
+static char* resolve_path(const char* list_path, const char* path)
+{
+	if (path[0] == '/')
+		return strdup(path);
+
+	const char* slash = strrchr(list_path, '/');
+	if (!slash)
+		return strdup(path);
+
+	const size_t dir_len = slash - list_path + 1;
+	char* full = (char*)malloc(dir_len + strlen(path) + 1);
+	if (!full)
+		return NULL;
+	memcpy(full, list_path, dir_len);
+	strcpy(full + dir_len, path);
+	return full;
+}
+
+static void trim_end(char* str)
+{
+	size_t len = strlen(str);
+	while (len > 0 && isspace((unsigned char)str[len - 1]))
+		str[--len] = '\0';
+}
+
+static bool in_midi_range(const int low, const int high)
+{
+	return low >= 0 && high <= MIDI_MAX && low <= high;
+}
+
+// the parsers fail a line they can't make sense of, and set no_memory as
+// well if the line was fine but there was nowhere to put it
+static bool parse_zone(const char* keymap_path,
+                       const char* line,
+                       struct keymap_zone* zone,
+                       bool* no_memory)
+{
+	int low_note, high_note, low_vel, high_vel;
+	unsigned round_robin;
+	int path_start = 0;
+	if (sscanf(line, "%d %d %d %d %u %n",
+	           &low_note, &high_note,
+	           &low_vel, &high_vel,
+	           &round_robin, &path_start) != 5 ||
+	    path_start == 0 || line[path_start] == '\0')
+		return false;
+	if (!in_midi_range(low_note, high_note) ||
+	    !in_midi_range(low_vel, high_vel))
+		return false;
+
+	zone->path          = resolve_path(keymap_path, line + path_start);
+	if (!zone->path) {
+		*no_memory = true;
+		return false;
+	}
+	zone->low_note      = low_note;
+	zone->high_note     = high_note;
+	zone->low_velocity  = low_vel;
+	zone->high_velocity = high_vel;
+	zone->round_robin   = round_robin;
+	return true;
+}
+
+// the next line that isn't blank or a comment, with its ends trimmed
+static const char* next_line(FILE* file,
+                             char* line,
+                             const size_t size,
+                             unsigned* line_no)
+{
+	while (fgets(line, size, file)) {
+		(*line_no)++;
+		trim_end(line);
+		const char* start = line;
+		while (isspace((unsigned char)*start))
+			start++;
+		if (*start != '\0' && *start != '#')
+			return start;
+	}
+	return NULL;
+}
+
+struct keymap_zone* read_keymap(const char* path, size_t* zone_cnt)
+{
+	*zone_cnt = 0;
+	FILE* file = fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Unable to read from %s\n", path);
+		return NULL;
+	}
+
+	size_t capacity = 16;
+	struct keymap_zone* zones =
+	        (struct keymap_zone*)malloc(sizeof(struct keymap_zone) *
+	                                    capacity);
+	bool no_memory = !zones;
+	char line[KEYMAP_LINE_MAX];
+	unsigned line_no = 0;
+	const char* start;
+	while (!no_memory &&
+	       (start = next_line(file, line, sizeof(line), &line_no))) {
+		if (*zone_cnt == capacity) {
+			struct keymap_zone* const grown = (struct keymap_zone*)
+			        realloc(zones,
+			                sizeof(struct keymap_zone) *
+			                capacity * 2);
+			if (!grown) {
+				no_memory = true;
+				break;
+			}
+			zones = grown;
+			capacity *= 2;
+		}
+		if (parse_zone(path, start, &zones[*zone_cnt], &no_memory))
+			(*zone_cnt)++;
+		else if (!no_memory)
+			fprintf(stderr,
+			        "WARN: skipping bad zone at %s:%u\n",
+			        path,
+			        line_no);
+	}
+	fclose(file);
+
+	if (no_memory) {
+		fprintf(stderr, "Out of memory reading %s\n", path);
+		free_keymap_zones(zones, *zone_cnt);
+		*zone_cnt = 0;
+		return NULL;
+	}
+	if (*zone_cnt == 0) {
+		fprintf(stderr, "No zones in %s\n", path);
+		free(zones);
+		return NULL;
+	}
+	return zones;
+}
+
+void free_keymap_zones(struct keymap_zone* zones, const size_t zone_cnt)
+{
+	for (size_t i = 0; i < zone_cnt; i++)
+		free(zones[i].path);
+	free(zones);
+}
+
+static bool parse_bank_entry(const char* bank_path,
+                             const char* line,
+                             struct bank_entry* entry,
+                             bool* no_memory)
+{
+	int program;
+	char kind[8];
+	int path_start = 0;
+	if (sscanf(line, "%d %7s %n", &program, kind, &path_start) != 2 ||
+	    path_start == 0 || line[path_start] == '\0')
+		return false;
+	if (program < 0 || program > MIDI_MAX)
+		return false;
+	if (!strcmp(kind, "keymap"))
+		entry->is_keymap = true;
+	else if (!strcmp(kind, "sample"))
+		entry->is_keymap = false;
+	else
+		return false;
+
+	entry->program = program;
+	entry->path    = resolve_path(bank_path, line + path_start);
+	if (!entry->path) {
+		*no_memory = true;
+		return false;
+	}
+	return true;
+}
+
+struct bank_entry* read_bank(const char* path, size_t* entry_cnt)
+{
+	*entry_cnt = 0;
+	FILE* file = fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Unable to read from %s\n", path);
+		return NULL;
+	}
+
+	struct bank_entry* entries =
+	        (struct bank_entry*)malloc(sizeof(struct bank_entry) *
+	                                   (MIDI_MAX + 1));
+	bool no_memory = !entries;
+	char line[KEYMAP_LINE_MAX];
+	unsigned line_no = 0;
+	const char* start;
+	while (!no_memory &&
+	       (start = next_line(file, line, sizeof(line), &line_no))) {
+		if (*entry_cnt == MIDI_MAX + 1) {
+			fprintf(stderr,
+			        "WARN: only %d presets fit in a bank\n",
+			        MIDI_MAX + 1);
+			break;
+		}
+		if (parse_bank_entry(path,
+		                     start,
+		                     &entries[*entry_cnt],
+		                     &no_memory))
+			(*entry_cnt)++;
+		else if (!no_memory)
+			fprintf(stderr,
+			        "WARN: skipping bad preset at %s:%u\n",
+			        path,
+			        line_no);
+	}
+	fclose(file);
+
+	if (no_memory) {
+		fprintf(stderr, "Out of memory reading %s\n", path);
+		free_bank_entries(entries, *entry_cnt);
+		*entry_cnt = 0;
+		return NULL;
+	}
+	if (*entry_cnt == 0) {
+		fprintf(stderr, "No presets in %s\n", path);
+		free(entries);
+		return NULL;
+	}
+	return entries;
+}
+
+void free_bank_entries(struct bank_entry* entries, const size_t entry_cnt)
+{
+	for (size_t i = 0; i < entry_cnt; i++)
+		free(entries[i].path);
+	free(entries);
+}
+
+static bool add_part_setting(struct part_entry* part,
+                             const char* name,
+                             const double value,
+                             bool* no_memory)
+{
+	if (strlen(name) >= PART_SETTING_NAME_MAX)
+		return false;
+	struct part_setting* const grown = (struct part_setting*)
+	        realloc(part->settings,
+	                sizeof(struct part_setting) * (part->setting_cnt + 1));
+	if (!grown) {
+		*no_memory = true;
+		return false;
+	}
+	part->settings = grown;
+	struct part_setting* setting = &part->settings[part->setting_cnt++];
+	strcpy(setting->name, name);
+	setting->value = value;
+	return true;
+}
+
+static bool parse_part_line(const char* parts_path,
+                            const char* line,
+                            struct part_entry* parts,
+                            bool* no_memory)
+{
+	int channel;
+	char key[PART_SETTING_NAME_MAX];
+	int rest_start = 0;
+	if (sscanf(line, "%d %31s %n", &channel, key, &rest_start) != 2 ||
+	    rest_start == 0 || line[rest_start] == '\0')
+		return false;
+	if (channel < 1 || channel > PART_CHANNELS)
+		return false;
+
+	struct part_entry* part = &parts[channel - 1];
+	const char* rest = line + rest_start;
+	if (!strcmp(key, "sample") || !strcmp(key, "keymap")) {
+		free(part->path);
+		part->path      = resolve_path(parts_path, rest);
+		part->is_keymap = !strcmp(key, "keymap");
+		if (!part->path) {
+			*no_memory = true;
+			return false;
+		}
+	} else {
+		char* end;
+		const double value = strtod(rest, &end);
+		if (end == rest || *end != '\0' ||
+		    !add_part_setting(part, key, value, no_memory))
+			return false;
+	}
+	part->used = true;
+	return true;
+}
+
+struct part_entry* read_parts(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Unable to read from %s\n", path);
+		return NULL;
+	}
+
+	struct part_entry* parts =
+	        (struct part_entry*)calloc(PART_CHANNELS,
+	                                   sizeof(struct part_entry));
+	if (!parts) {
+		fclose(file);
+		fprintf(stderr, "Out of memory reading %s\n", path);
+		return NULL;
+	}
+	bool any = false;
+	bool no_memory = false;
+	char line[KEYMAP_LINE_MAX];
+	unsigned line_no = 0;
+	const char* start;
+	while (!no_memory &&
+	       (start = next_line(file, line, sizeof(line), &line_no))) {
+		if (parse_part_line(path, start, parts, &no_memory))
+			any = true;
+		else if (!no_memory)
+			fprintf(stderr,
+			        "WARN: skipping bad part at %s:%u\n",
+			        path,
+			        line_no);
+	}
+	fclose(file);
+
+	if (no_memory) {
+		fprintf(stderr, "Out of memory reading %s\n", path);
+		free_part_entries(parts);
+		return NULL;
+	}
+	if (!any) {
+		fprintf(stderr, "No parts in %s\n", path);
+		free_part_entries(parts);
+		return NULL;
+	}
+	return parts;
+}
+
+void free_part_entries(struct part_entry* parts)
+{
+	for (size_t i = 0; i < PART_CHANNELS; i++) {
+		free(parts[i].path);
+		free(parts[i].settings);
+	}
+	free(parts);
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef a7d3e91c5b2f4e08b6c1d4f2e9a0b375
+#define a7d3e91c5b2f4e08b6c1d4f2e9a0b375
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// a keymap file has one zone per line:
+//
+//     low_note high_note low_velocity high_velocity round_robin path
+//
+// ranges are inclusive, and zones with the same ranges and the same
+// non-zero round robin group take turns; relative paths are relative to
+// the keymap file, and lines starting with # are comments
+
+struct keymap_zone {
+	char*    path;
+	uint8_t  low_note;
+	uint8_t  high_note;
+	uint8_t  low_velocity;
+	uint8_t  high_velocity;
+	unsigned round_robin;
+};
+
+struct keymap_zone* read_keymap(const char* path, size_t* zone_cnt);
+void free_keymap_zones(struct keymap_zone* zones, size_t zone_cnt);
+
+// a bank file has one preset per line, either a single sample or a keymap
+// for a MIDI program:
+//
+//     program sample path
+//     program keymap path
+
+struct bank_entry {
+	char*   path;
+	uint8_t program;
+	bool    is_keymap;
+};
+
+struct bank_entry* read_bank(const char* path, size_t* entry_cnt);
+void free_bank_entries(struct bank_entry* entries, size_t entry_cnt);
+
+// a parts file gives MIDI channels a sample or keymap and settings of
+// their own, one per line:
+//
+//     channel sample path
+//     channel keymap path
+//     channel setting value
+//
+// channels count from 1 and settings are named after the plugin's control
+// ports, taking the same values; channels without a line play the loose
+// sample with the port settings
+
+#define PART_CHANNELS 16
+#define PART_SETTING_NAME_MAX 32
+
+struct part_setting {
+	char   name[PART_SETTING_NAME_MAX];
+	double value;
+};
+
+struct part_entry {
+	bool                 used;
+	char*                path;
+	bool                 is_keymap;
+	struct part_setting* settings;
+	size_t               setting_cnt;
+};
+
+// always PART_CHANNELS entries
+struct part_entry* read_parts(const char* path);
+void free_part_entries(struct part_entry* parts);
+
+#endif
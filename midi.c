@@ -0,0 +1,298 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "midi.h"
+
+#define BEND_CENTER 8192
+
+#define DEFAULT_BEND_RANGE 2
+#define MPE_BEND_RANGE     48
+#define RPN_BEND_RANGE     0x0000
+#define RPN_MPE_CONFIG     0x0006
+#define RPN_NULL           0x3fff
+#define LOWER_ZONE_MANAGER 0
+#define UPPER_ZONE_MANAGER (MIDI_CHANNELS - 1)
+
+void reset_midi_input(struct midi_input* input)
+{
+	memset(input, '\0', sizeof(struct midi_input));
+}
+
+static uint8_t data_len(const uint8_t status)
+{
+	const uint8_t type = status & 0xf0;
+	return type == 0xc0 || type == 0xd0 ? 1 : 2;
+}
+
+static void release_channel(struct midi_input* input,
+                            const uint8_t channel,
+                            midi_event_handler handle,
+                            void* data)
+{
+	uint8_t* held = input->held[channel];
+	for (unsigned note = 0; note < MIDI_KEYS; note++) {
+		if (!held[note])
+			continue;
+		held[note] = 0;
+		const struct midi_event off = {
+			.type     = MIDI_NOTE_OFF,
+			.channel  = channel,
+			.note     = note,
+			.velocity = 0,
+			.bend     = 0
+		};
+		handle(data, &off);
+	}
+}
+
+static void finish_message(struct midi_input* input,
+                           midi_event_handler handle,
+                           void* data)
+{
+	struct midi_event event = {
+		.channel  = input->status & 0x0f,
+		.note     = input->data[0],
+		.velocity = input->data_cnt > 1 ? input->data[1] : 0,
+		.bend     = 0
+	};
+	uint8_t* held = input->held[event.channel];
+
+	switch (input->status & 0xf0) {
+	case 0x90:
+		if (event.velocity > 0) {
+			if (held[event.note]) {
+				struct midi_event off = event;
+				off.type = MIDI_NOTE_OFF;
+				off.velocity = 0;
+				handle(data, &off);
+			}
+			held[event.note] = event.velocity;
+			event.type = MIDI_NOTE_ON;
+			break;
+		}
+		// fall through, velocity 0 is a note off
+	case 0x80:
+		if (!held[event.note])
+			return;
+		held[event.note] = 0;
+		event.type = MIDI_NOTE_OFF;
+		break;
+	case 0xa0:
+		event.type = MIDI_POLY_PRESSURE;
+		break;
+	case 0xb0:
+		if (event.note == MIDI_CC_ALL_SOUND_OFF ||
+		    event.note == MIDI_CC_ALL_NOTES_OFF)
+			release_channel(input, event.channel, handle, data);
+		event.type = MIDI_CONTROL;
+		break;
+	case 0xc0:
+		event.type = MIDI_PROGRAM;
+		break;
+	case 0xd0:
+		event.type = MIDI_PRESSURE;
+		break;
+	default:
+		event.type = MIDI_PITCH_BEND;
+		event.bend = (event.note | event.velocity << 7) - BEND_CENTER;
+		break;
+	}
+	handle(data, &event);
+}
+
+void read_midi_bytes(struct midi_input* input,
+                     const uint8_t* bytes,
+                     const size_t size,
+                     midi_event_handler handle,
+                     void* data)
+{
+	for (size_t i = 0; i < size; i++) {
+		const uint8_t byte = bytes[i];
+		// real time messages can land anywhere, even mid message
+		if (byte >= 0xf8)
+			continue;
+
+		if (byte & 0x80) {
+			// system messages cancel running status, and their data
+			// bytes are dropped along with it
+			input->in_sysex = byte == 0xf0;
+			input->status = byte < 0xf0 ? byte : 0;
+			input->data_cnt = 0;
+			continue;
+		}
+		if (input->in_sysex || !input->status)
+			continue;
+
+		input->data[input->data_cnt++] = byte;
+		if (input->data_cnt == data_len(input->status)) {
+			finish_message(input, handle, data);
+			input->data_cnt = 0;
+		}
+	}
+}
+
+// the reverse, for a consumer that still wants bytes; returns how many
+// of MIDI_EVENT_BYTES were written
+size_t write_midi_event(const struct midi_event* event, uint8_t* bytes)
+{
+	static const uint8_t statuses[] = {
+		[MIDI_NOTE_OFF]      = 0x80,
+		[MIDI_NOTE_ON]       = 0x90,
+		[MIDI_POLY_PRESSURE] = 0xa0,
+		[MIDI_CONTROL]       = 0xb0,
+		[MIDI_PROGRAM]       = 0xc0,
+		[MIDI_PRESSURE]      = 0xd0,
+		[MIDI_PITCH_BEND]    = 0xe0
+	};
+
+	const uint8_t status = statuses[event->type] | event->channel;
+	bytes[0] = status;
+	if (event->type == MIDI_PITCH_BEND) {
+		const unsigned bend = event->bend + BEND_CENTER;
+		bytes[1] = bend & 0x7f;
+		bytes[2] = (bend >> 7) & 0x7f;
+		return 3;
+	}
+	bytes[1] = event->note;
+	if (data_len(status) == 1)
+		return 2;
+	bytes[2] = event->velocity;
+	return 3;
+}
+
+static void reset_channel_expression(struct midi_expression_state* state,
+                                     const uint8_t channel)
+{
+	state->bend[channel] = 0;
+	state->channels[channel] = (struct midi_expression){
+		.bend     = 0,
+		.pressure = state->mpe_member[channel] ? 0 : 1,
+		.slide    = 0
+	};
+}
+
+void reset_midi_expression(struct midi_expression_state* state)
+{
+	memset(state, '\0', sizeof(struct midi_expression_state));
+	for (uint8_t channel = 0; channel < MIDI_CHANNELS; channel++) {
+		state->rpn[channel] = RPN_NULL;
+		state->bend_range[channel] = DEFAULT_BEND_RANGE;
+		reset_channel_expression(state, channel);
+	}
+}
+
+// the zones split the channels between them, and whichever was set up
+// last gets its way where they overlap
+static void configure_zones(struct midi_expression_state* state,
+                            const uint8_t manager,
+                            uint8_t members)
+{
+	if (members > MIDI_CHANNELS - 1)
+		members = MIDI_CHANNELS - 1;
+	uint8_t* zone = &state->lower_members;
+	uint8_t* other = &state->upper_members;
+	if (manager == UPPER_ZONE_MANAGER) {
+		zone = &state->upper_members;
+		other = &state->lower_members;
+	}
+	*zone = members;
+	// with both zones in use, each has a manager channel of its own
+	const uint8_t room = MIDI_CHANNELS - 2;
+	if (*other > 0 && *other + members > room)
+		*other = members < room ? room - members : 0;
+
+	for (uint8_t channel = 0; channel < MIDI_CHANNELS; channel++) {
+		const bool member =
+		        (channel > LOWER_ZONE_MANAGER &&
+		         channel <= state->lower_members) ||
+		        (channel < UPPER_ZONE_MANAGER &&
+		         channel >= UPPER_ZONE_MANAGER - state->upper_members);
+		state->mpe_member[channel] = member;
+		state->bend_range[channel] = member ? MPE_BEND_RANGE :
+		                                      DEFAULT_BEND_RANGE;
+		reset_channel_expression(state, channel);
+	}
+}
+
+static bool read_data_entry(struct midi_expression_state* state,
+                            const uint8_t channel,
+                            const uint8_t value)
+{
+	const uint16_t rpn = state->rpn[channel];
+	if (rpn == RPN_BEND_RANGE) {
+		state->bend_range[channel] = value;
+		state->channels[channel].bend = (double)state->bend[channel] /
+		                                BEND_CENTER * value;
+		return true;
+	}
+	if (rpn == RPN_MPE_CONFIG &&
+	    (channel == LOWER_ZONE_MANAGER || channel == UPPER_ZONE_MANAGER)) {
+		configure_zones(state, channel, value);
+		return true;
+	}
+	return false;
+}
+
+static bool read_control(struct midi_expression_state* state,
+                         const struct midi_event* event)
+{
+	const uint8_t channel = event->channel;
+	uint16_t* rpn = &state->rpn[channel];
+	switch (event->note) {
+	case MIDI_CC_RPN_MSB:
+		*rpn = (*rpn & 0x7f) | event->velocity << 7;
+		return false;
+	case MIDI_CC_RPN_LSB:
+		*rpn = (*rpn & 0x3f80) | event->velocity;
+		return false;
+	case MIDI_CC_DATA_ENTRY:
+		return read_data_entry(state, channel, event->velocity);
+	case MIDI_CC_SLIDE:
+		if (!state->mpe_member[channel])
+			return false;
+		state->channels[channel].slide =
+		        (event->velocity - 64) / 64.0;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool read_midi_expression(struct midi_expression_state* state,
+                          const struct midi_event* event)
+{
+	const uint8_t channel = event->channel;
+	struct midi_expression* expression = &state->channels[channel];
+	switch (event->type) {
+	case MIDI_PITCH_BEND:
+		state->bend[channel] = event->bend;
+		expression->bend = (double)event->bend / BEND_CENTER *
+		                   state->bend_range[channel];
+		return true;
+	case MIDI_PRESSURE:
+		if (!state->mpe_member[channel])
+			return false;
+		expression->pressure = event->note / 127.0;
+		return true;
+	case MIDI_CONTROL:
+		return read_control(state, event);
+	default:
+		return false;
+	}
+}
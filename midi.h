@@ -0,0 +1,108 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef e573eabba444a8193bda721f4a1beea1
+#define e573eabba444a8193bda721f4a1beea1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// raw MIDI bytes in, whole channel events out: running status is followed
+// across calls, note on with velocity 0 is a note off, and the held notes
+// of every channel are tracked so that a stray note off never reaches a
+// voice and a repeated note on releases the note it restarts
+
+#define MIDI_CHANNELS 16
+#define MIDI_KEYS     128
+
+#define MIDI_EVENT_BYTES 3
+
+#define MIDI_CC_DATA_ENTRY    6
+#define MIDI_CC_SLIDE         74
+#define MIDI_CC_RPN_LSB       100
+#define MIDI_CC_RPN_MSB       101
+#define MIDI_CC_ALL_SOUND_OFF 120
+#define MIDI_CC_ALL_NOTES_OFF 123
+
+enum midi_event_type {
+	MIDI_NOTE_OFF,
+	MIDI_NOTE_ON,
+	MIDI_POLY_PRESSURE,
+	MIDI_CONTROL,
+	MIDI_PROGRAM,
+	MIDI_PRESSURE,
+	MIDI_PITCH_BEND
+};
+
+// note and velocity hold the two data bytes whatever the type, and a
+// pitch bend also has them joined up in bend, centered on 0
+struct midi_event {
+	enum midi_event_type type;
+	uint8_t              channel;
+	uint8_t              note;
+	uint8_t              velocity;
+	int16_t              bend;
+};
+
+struct midi_input {
+	uint8_t status;
+	uint8_t data[2];
+	uint8_t data_cnt;
+	bool    in_sysex;
+	// the velocity each note was started with, 0 while it is off
+	uint8_t held[MIDI_CHANNELS][MIDI_KEYS];
+};
+
+typedef void (*midi_event_handler)(void* data, const struct midi_event* event);
+
+void reset_midi_input(struct midi_input* input);
+void read_midi_bytes(struct midi_input* input,
+                     const uint8_t* bytes,
+                     size_t size,
+                     midi_event_handler handle,
+                     void* data);
+size_t write_midi_event(const struct midi_event* event, uint8_t* bytes);
+
+// what bend, pressure and slide come to on each channel, following the
+// bend range RPN and the MPE configuration message: member channels of
+// an MPE zone bend 48 semitones and add pressure and slide, starting from
+// none of either, everywhere else pressure stays at 1 and slide at 0,
+// since a plain keyboard's aftertouch and CC 74 mean something else
+struct midi_expression {
+	double bend;
+	double pressure;
+	double slide;
+};
+
+struct midi_expression_state {
+	uint16_t               rpn[MIDI_CHANNELS];
+	double                 bend_range[MIDI_CHANNELS];
+	int16_t                bend[MIDI_CHANNELS];
+	bool                   mpe_member[MIDI_CHANNELS];
+	uint8_t                lower_members;
+	uint8_t                upper_members;
+	struct midi_expression channels[MIDI_CHANNELS];
+};
+
+void reset_midi_expression(struct midi_expression_state* state);
+// true when the event changed its channel's expression, or every
+// channel's when it reconfigured a zone
+bool read_midi_expression(struct midi_expression_state* state,
+                          const struct midi_event* event);
+
+#endif
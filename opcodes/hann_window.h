@@ -1,1031 +0,0 @@
-#ifndef oe32084267a941fdba402ab2ca2487c8
-#define oe32084267a941fdba402ab2ca2487c8
-
-const double hann_window[] = {
-	0.00000000, 0.00000059, 0.00000235, 0.00000529,
-	0.00000941, 0.00001471, 0.00002118, 0.00002883,
-	0.00003765, 0.00004765, 0.00005883, 0.00007118,
-	0.00008471, 0.00009942, 0.00011530, 0.00013236,
-	0.00015059, 0.00017000, 0.00019059, 0.00021235,
-	0.00023529, 0.00025941, 0.00028470, 0.00031116,
-	0.00033881, 0.00036763, 0.00039762, 0.00042879,
-	0.00046114, 0.00049466, 0.00052935, 0.00056523,
-	0.00060227, 0.00064049, 0.00067989, 0.00072046,
-	0.00076221, 0.00080513, 0.00084923, 0.00089450,
-	0.00094094, 0.00098856, 0.00103736, 0.00108732,
-	0.00113847, 0.00119078, 0.00124427, 0.00129894,
-	0.00135477, 0.00141178, 0.00146996, 0.00152932,
-	0.00158985, 0.00165155, 0.00171443, 0.00177847,
-	0.00184369, 0.00191009, 0.00197765, 0.00204639,
-	0.00211629, 0.00218737, 0.00225962, 0.00233304,
-	0.00240764, 0.00248340, 0.00256033, 0.00263844,
-	0.00271771, 0.00279816, 0.00287978, 0.00296256,
-	0.00304651, 0.00313164, 0.00321793, 0.00330539,
-	0.00339403, 0.00348382, 0.00357479, 0.00366693,
-	0.00376023, 0.00385470, 0.00395034, 0.00404715,
-	0.00414512, 0.00424426, 0.00434457, 0.00444604,
-	0.00454868, 0.00465249, 0.00475746, 0.00486359,
-	0.00497089, 0.00507936, 0.00518899, 0.00529979,
-	0.00541175, 0.00552487, 0.00563915, 0.00575460,
-	0.00587122, 0.00598899, 0.00610793, 0.00622803,
-	0.00634929, 0.00647171, 0.00659530, 0.00672004,
-	0.00684595, 0.00697302, 0.00710125, 0.00723063,
-	0.00736118, 0.00749288, 0.00762575, 0.00775977,
-	0.00789495, 0.00803129, 0.00816879, 0.00830744,
-	0.00844726, 0.00858822, 0.00873035, 0.00887363,
-	0.00901807, 0.00916366, 0.00931040, 0.00945830,
-	0.00960736, 0.00975757, 0.00990893, 0.01006145,
-	0.01021512, 0.01036994, 0.01052591, 0.01068304,
-	0.01084131, 0.01100074, 0.01116132, 0.01132305,
-	0.01148593, 0.01164996, 0.01181513, 0.01198146,
-	0.01214893, 0.01231756, 0.01248733, 0.01265824,
-	0.01283031, 0.01300352, 0.01317788, 0.01335338,
-	0.01353002, 0.01370782, 0.01388675, 0.01406683,
-	0.01424805, 0.01443042, 0.01461393, 0.01479858,
-	0.01498437, 0.01517131, 0.01535938, 0.01554860,
-	0.01573895, 0.01593045, 0.01612308, 0.01631685,
-	0.01651176, 0.01670781, 0.01690500, 0.01710332,
-	0.01730278, 0.01750337, 0.01770510, 0.01790797,
-	0.01811197, 0.01831710, 0.01852337, 0.01873077,
-	0.01893930, 0.01914896, 0.01935976, 0.01957168,
-	0.01978474, 0.01999893, 0.02021424, 0.02043069,
-	0.02064826, 0.02086696, 0.02108679, 0.02130775,
-	0.02152983, 0.02175304, 0.02197737, 0.02220283,
-	0.02242942, 0.02265712, 0.02288595, 0.02311591,
-	0.02334698, 0.02357918, 0.02381249, 0.02404693,
-	0.02428249, 0.02451917, 0.02475696, 0.02499588,
-	0.02523591, 0.02547706, 0.02571933, 0.02596271,
-	0.02620720, 0.02645282, 0.02669954, 0.02694738,
-	0.02719634, 0.02744640, 0.02769758, 0.02794987,
-	0.02820327, 0.02845778, 0.02871340, 0.02897013,
-	0.02922797, 0.02948691, 0.02974696, 0.03000812,
-	0.03027039, 0.03053376, 0.03079823, 0.03106381,
-	0.03133049, 0.03159828, 0.03186717, 0.03213716,
-	0.03240825, 0.03268044, 0.03295372, 0.03322811,
-	0.03350360, 0.03378019, 0.03405787, 0.03433665,
-	0.03461652, 0.03489749, 0.03517955, 0.03546271,
-	0.03574696, 0.03603230, 0.03631874, 0.03660626,
-	0.03689488, 0.03718458, 0.03747538, 0.03776726,
-	0.03806023, 0.03835429, 0.03864944, 0.03894567,
-	0.03924298, 0.03954138, 0.03984086, 0.04014143,
-	0.04044307, 0.04074580, 0.04104961, 0.04135450,
-	0.04166047, 0.04196752, 0.04227564, 0.04258484,
-	0.04289512, 0.04320648, 0.04351890, 0.04383241,
-	0.04414698, 0.04446263, 0.04477935, 0.04509715,
-	0.04541601, 0.04573594, 0.04605694, 0.04637901,
-	0.04670215, 0.04702635, 0.04735162, 0.04767795,
-	0.04800535, 0.04833382, 0.04866334, 0.04899393,
-	0.04932558, 0.04965829, 0.04999205, 0.05032688,
-	0.05066277, 0.05099971, 0.05133771, 0.05167676,
-	0.05201688, 0.05235804, 0.05270026, 0.05304353,
-	0.05338785, 0.05373322, 0.05407965, 0.05442712,
-	0.05477564, 0.05512521, 0.05547582, 0.05582748,
-	0.05618019, 0.05653394, 0.05688873, 0.05724457,
-	0.05760145, 0.05795937, 0.05831833, 0.05867833,
-	0.05903937, 0.05940144, 0.05976456, 0.06012870,
-	0.06049389, 0.06086010, 0.06122735, 0.06159564,
-	0.06196495, 0.06233530, 0.06270667, 0.06307908,
-	0.06345251, 0.06382697, 0.06420246, 0.06457897,
-	0.06495650, 0.06533506, 0.06571465, 0.06609525,
-	0.06647688, 0.06685952, 0.06724319, 0.06762787,
-	0.06801357, 0.06840029, 0.06878802, 0.06917677,
-	0.06956653, 0.06995730, 0.07034909, 0.07074189,
-	0.07113569, 0.07153051, 0.07192634, 0.07232317,
-	0.07272101, 0.07311985, 0.07351970, 0.07392055,
-	0.07432240, 0.07472526, 0.07512912, 0.07553397,
-	0.07593983, 0.07634668, 0.07675453, 0.07716338,
-	0.07757322, 0.07798405, 0.07839588, 0.07880870,
-	0.07922251, 0.07963731, 0.08005310, 0.08046988,
-	0.08088765, 0.08130640, 0.08172614, 0.08214686,
-	0.08256856, 0.08299125, 0.08341492, 0.08383957,
-	0.08426519, 0.08469180, 0.08511938, 0.08554794,
-	0.08597748, 0.08640799, 0.08683947, 0.08727192,
-	0.08770535, 0.08813974, 0.08857511, 0.08901144,
-	0.08944874, 0.08988701, 0.09032624, 0.09076644,
-	0.09120759, 0.09164971, 0.09209279, 0.09253684,
-	0.09298184, 0.09342779, 0.09387471, 0.09432258,
-	0.09477140, 0.09522118, 0.09567191, 0.09612359,
-	0.09657622, 0.09702980, 0.09748433, 0.09793981,
-	0.09839623, 0.09885360, 0.09931191, 0.09977117,
-	0.10023137, 0.10069250, 0.10115458, 0.10161759,
-	0.10208155, 0.10254644, 0.10301226, 0.10347902,
-	0.10394671, 0.10441533, 0.10488489, 0.10535537,
-	0.10582679, 0.10629913, 0.10677239, 0.10724659,
-	0.10772170, 0.10819774, 0.10867470, 0.10915258,
-	0.10963139, 0.11011111, 0.11059174, 0.11107330,
-	0.11155577, 0.11203915, 0.11252345, 0.11300865,
-	0.11349477, 0.11398180, 0.11446974, 0.11495858,
-	0.11544833, 0.11593899, 0.11643054, 0.11692300,
-	0.11741637, 0.11791063, 0.11840579, 0.11890185,
-	0.11939881, 0.11989666, 0.12039541, 0.12089505,
-	0.12139558, 0.12189700, 0.12239931, 0.12290251,
-	0.12340660, 0.12391157, 0.12441743, 0.12492418,
-	0.12543180, 0.12594031, 0.12644970, 0.12695996,
-	0.12747111, 0.12798313, 0.12849602, 0.12900979,
-	0.12952444, 0.13003995, 0.13055634, 0.13107359,
-	0.13159172, 0.13211071, 0.13263056, 0.13315128,
-	0.13367286, 0.13419531, 0.13471862, 0.13524278,
-	0.13576780, 0.13629369, 0.13682042, 0.13734801,
-	0.13787646, 0.13840576, 0.13893590, 0.13946690,
-	0.13999875, 0.14053144, 0.14106498, 0.14159936,
-	0.14213459, 0.14267066, 0.14320757, 0.14374531,
-	0.14428390, 0.14482333, 0.14536359, 0.14590468,
-	0.14644661, 0.14698937, 0.14753296, 0.14807738,
-	0.14862263, 0.14916870, 0.14971560, 0.15026333,
-	0.15081188, 0.15136124, 0.15191143, 0.15246244,
-	0.15301427, 0.15356691, 0.15412037, 0.15467464,
-	0.15522973, 0.15578562, 0.15634233, 0.15689984,
-	0.15745817, 0.15801729, 0.15857723, 0.15913796,
-	0.15969950, 0.16026184, 0.16082498, 0.16138891,
-	0.16195365, 0.16251918, 0.16308550, 0.16365262,
-	0.16422052, 0.16478922, 0.16535871, 0.16592898,
-	0.16650004, 0.16707188, 0.16764451, 0.16821792,
-	0.16879211, 0.16936708, 0.16994283, 0.17051935,
-	0.17109665, 0.17167473, 0.17225357, 0.17283319,
-	0.17341358, 0.17399473, 0.17457666, 0.17515935,
-	0.17574280, 0.17632702, 0.17691199, 0.17749773,
-	0.17808423, 0.17867148, 0.17925949, 0.17984826,
-	0.18043778, 0.18102805, 0.18161907, 0.18221084,
-	0.18280336, 0.18339662, 0.18399063, 0.18458539,
-	0.18518088, 0.18577712, 0.18637409, 0.18697181,
-	0.18757026, 0.18816944, 0.18876936, 0.18937001,
-	0.18997139, 0.19057351, 0.19117635, 0.19177991,
-	0.19238420, 0.19298922, 0.19359496, 0.19420142,
-	0.19480860, 0.19541649, 0.19602511, 0.19663444,
-	0.19724448, 0.19785523, 0.19846670, 0.19907888,
-	0.19969176, 0.20030535, 0.20091965, 0.20153465,
-	0.20215035, 0.20276675, 0.20338385, 0.20400165,
-	0.20462015, 0.20523934, 0.20585923, 0.20647980,
-	0.20710107, 0.20772303, 0.20834567, 0.20896900,
-	0.20959302, 0.21021772, 0.21084310, 0.21146916,
-	0.21209590, 0.21272332, 0.21335142, 0.21398019,
-	0.21460963, 0.21523974, 0.21587052, 0.21650198,
-	0.21713409, 0.21776688, 0.21840033, 0.21903444,
-	0.21966921, 0.22030464, 0.22094073, 0.22157748,
-	0.22221488, 0.22285294, 0.22349165, 0.22413101,
-	0.22477101, 0.22541167, 0.22605297, 0.22669492,
-	0.22733751, 0.22798074, 0.22862461, 0.22926912,
-	0.22991426, 0.23056005, 0.23120646, 0.23185351,
-	0.23250119, 0.23314950, 0.23379844, 0.23444800,
-	0.23509819, 0.23574900, 0.23640043, 0.23705249,
-	0.23770516, 0.23835845, 0.23901235, 0.23966687,
-	0.24032200, 0.24097775, 0.24163410, 0.24229106,
-	0.24294863, 0.24360680, 0.24426557, 0.24492495,
-	0.24558493, 0.24624550, 0.24690668, 0.24756845,
-	0.24823081, 0.24889376, 0.24955731, 0.25022144,
-	0.25088617, 0.25155148, 0.25221737, 0.25288385,
-	0.25355090, 0.25421854, 0.25488676, 0.25555555,
-	0.25622492, 0.25689486, 0.25756538, 0.25823646,
-	0.25890811, 0.25958033, 0.26025312, 0.26092647,
-	0.26160038, 0.26227486, 0.26294989, 0.26362548,
-	0.26430163, 0.26497833, 0.26565559, 0.26633340,
-	0.26701175, 0.26769066, 0.26837011, 0.26905010,
-	0.26973064, 0.27041173, 0.27109335, 0.27177551,
-	0.27245821, 0.27314144, 0.27382521, 0.27450951,
-	0.27519434, 0.27587969, 0.27656558, 0.27725199,
-	0.27793893, 0.27862639, 0.27931437, 0.28000286,
-	0.28069188, 0.28138141, 0.28207146, 0.28276202,
-	0.28345309, 0.28414467, 0.28483676, 0.28552935,
-	0.28622245, 0.28691606, 0.28761016, 0.28830476,
-	0.28899986, 0.28969546, 0.29039156, 0.29108814,
-	0.29178522, 0.29248279, 0.29318084, 0.29387939,
-	0.29457841, 0.29527793, 0.29597792, 0.29667839,
-	0.29737934, 0.29808077, 0.29878267, 0.29948505,
-	0.30018790, 0.30089122, 0.30159501, 0.30229926,
-	0.30300398, 0.30370916, 0.30441481, 0.30512091,
-	0.30582748, 0.30653450, 0.30724197, 0.30794990,
-	0.30865828, 0.30936712, 0.31007640, 0.31078612,
-	0.31149629, 0.31220691, 0.31291797, 0.31362947,
-	0.31434140, 0.31505378, 0.31576659, 0.31647983,
-	0.31719350, 0.31790761, 0.31862214, 0.31933710,
-	0.32005248, 0.32076829, 0.32148452, 0.32220117,
-	0.32291824, 0.32363572, 0.32435362, 0.32507194,
-	0.32579066, 0.32650979, 0.32722934, 0.32794929,
-	0.32866964, 0.32939040, 0.33011156, 0.33083312,
-	0.33155507, 0.33227743, 0.33300017, 0.33372332,
-	0.33444685, 0.33517077, 0.33589508, 0.33661977,
-	0.33734485, 0.33807032, 0.33879616, 0.33952238,
-	0.34024898, 0.34097596, 0.34170331, 0.34243104,
-	0.34315913, 0.34388759, 0.34461642, 0.34534562,
-	0.34607518, 0.34680510, 0.34753539, 0.34826603,
-	0.34899703, 0.34972838, 0.35046009, 0.35119215,
-	0.35192456, 0.35265731, 0.35339042, 0.35412387,
-	0.35485766, 0.35559180, 0.35632627, 0.35706108,
-	0.35779623, 0.35853171, 0.35926753, 0.36000368,
-	0.36074016, 0.36147696, 0.36221409, 0.36295155,
-	0.36368932, 0.36442742, 0.36516584, 0.36590457,
-	0.36664362, 0.36738298, 0.36812266, 0.36886265,
-	0.36960294, 0.37034354, 0.37108445, 0.37182566,
-	0.37256717, 0.37330898, 0.37405109, 0.37479350,
-	0.37553620, 0.37627919, 0.37702247, 0.37776605,
-	0.37850991, 0.37925406, 0.37999849, 0.38074320,
-	0.38148820, 0.38223347, 0.38297902, 0.38372485,
-	0.38447095, 0.38521732, 0.38596396, 0.38671087,
-	0.38745804, 0.38820549, 0.38895319, 0.38970115,
-	0.39044938, 0.39119786, 0.39194660, 0.39269559,
-	0.39344484, 0.39419434, 0.39494408, 0.39569407,
-	0.39644431, 0.39719479, 0.39794552, 0.39869648,
-	0.39944768, 0.40019912, 0.40095079, 0.40170270,
-	0.40245484, 0.40320721, 0.40395980, 0.40471262,
-	0.40546567, 0.40621894, 0.40697242, 0.40772613,
-	0.40848006, 0.40923420, 0.40998855, 0.41074311,
-	0.41149789, 0.41225287, 0.41300806, 0.41376346,
-	0.41451906, 0.41527485, 0.41603085, 0.41678705,
-	0.41754344, 0.41830003, 0.41905680, 0.41981377,
-	0.42057093, 0.42132827, 0.42208580, 0.42284351,
-	0.42360141, 0.42435948, 0.42511773, 0.42587616,
-	0.42663476, 0.42739354, 0.42815248, 0.42891160,
-	0.42967088, 0.43043033, 0.43118994, 0.43194971,
-	0.43270965, 0.43346974, 0.43422999, 0.43499039,
-	0.43575094, 0.43651165, 0.43727251, 0.43803351,
-	0.43879466, 0.43955596, 0.44031739, 0.44107897,
-	0.44184068, 0.44260254, 0.44336452, 0.44412664,
-	0.44488890, 0.44565128, 0.44641379, 0.44717642,
-	0.44793918, 0.44870207, 0.44946507, 0.45022819,
-	0.45099143, 0.45175478, 0.45251825, 0.45328183,
-	0.45404552, 0.45480932, 0.45557322, 0.45633723,
-	0.45710134, 0.45786556, 0.45862987, 0.45939428,
-	0.46015878, 0.46092338, 0.46168807, 0.46245285,
-	0.46321772, 0.46398267, 0.46474771, 0.46551284,
-	0.46627804, 0.46704332, 0.46780868, 0.46857412,
-	0.46933963, 0.47010521, 0.47087087, 0.47163659,
-	0.47240238, 0.47316823, 0.47393415, 0.47470013,
-	0.47546616, 0.47623226, 0.47699841, 0.47776461,
-	0.47853087, 0.47929718, 0.48006354, 0.48082994,
-	0.48159639, 0.48236288, 0.48312941, 0.48389599,
-	0.48466260, 0.48542925, 0.48619593, 0.48696264,
-	0.48772939, 0.48849616, 0.48926296, 0.49002979,
-	0.49079664, 0.49156351, 0.49233040, 0.49309731,
-	0.49386423, 0.49463117, 0.49539812, 0.49616509,
-	0.49693206, 0.49769904, 0.49846602, 0.49923301,
-	0.50000000, 0.50076699, 0.50153398, 0.50230096,
-	0.50306794, 0.50383491, 0.50460188, 0.50536883,
-	0.50613577, 0.50690269, 0.50766960, 0.50843649,
-	0.50920336, 0.50997021, 0.51073704, 0.51150384,
-	0.51227061, 0.51303736, 0.51380407, 0.51457075,
-	0.51533740, 0.51610401, 0.51687059, 0.51763712,
-	0.51840361, 0.51917006, 0.51993646, 0.52070282,
-	0.52146913, 0.52223539, 0.52300159, 0.52376774,
-	0.52453384, 0.52529987, 0.52606585, 0.52683177,
-	0.52759762, 0.52836341, 0.52912913, 0.52989479,
-	0.53066037, 0.53142588, 0.53219132, 0.53295668,
-	0.53372196, 0.53448716, 0.53525229, 0.53601733,
-	0.53678228, 0.53754715, 0.53831193, 0.53907662,
-	0.53984122, 0.54060572, 0.54137013, 0.54213444,
-	0.54289866, 0.54366277, 0.54442678, 0.54519068,
-	0.54595448, 0.54671817, 0.54748175, 0.54824522,
-	0.54900857, 0.54977181, 0.55053493, 0.55129793,
-	0.55206082, 0.55282358, 0.55358621, 0.55434872,
-	0.55511110, 0.55587336, 0.55663548, 0.55739746,
-	0.55815932, 0.55892103, 0.55968261, 0.56044404,
-	0.56120534, 0.56196649, 0.56272749, 0.56348835,
-	0.56424906, 0.56500961, 0.56577001, 0.56653026,
-	0.56729035, 0.56805029, 0.56881006, 0.56956967,
-	0.57032912, 0.57108840, 0.57184752, 0.57260646,
-	0.57336524, 0.57412384, 0.57488227, 0.57564052,
-	0.57639859, 0.57715649, 0.57791420, 0.57867173,
-	0.57942907, 0.58018623, 0.58094320, 0.58169997,
-	0.58245656, 0.58321295, 0.58396915, 0.58472515,
-	0.58548094, 0.58623654, 0.58699194, 0.58774713,
-	0.58850211, 0.58925689, 0.59001145, 0.59076580,
-	0.59151994, 0.59227387, 0.59302758, 0.59378106,
-	0.59453433, 0.59528738, 0.59604020, 0.59679279,
-	0.59754516, 0.59829730, 0.59904921, 0.59980088,
-	0.60055232, 0.60130352, 0.60205448, 0.60280521,
-	0.60355569, 0.60430593, 0.60505592, 0.60580566,
-	0.60655516, 0.60730441, 0.60805340, 0.60880214,
-	0.60955062, 0.61029885, 0.61104681, 0.61179451,
-	0.61254196, 0.61328913, 0.61403604, 0.61478268,
-	0.61552905, 0.61627515, 0.61702098, 0.61776653,
-	0.61851180, 0.61925680, 0.62000151, 0.62074594,
-	0.62149009, 0.62223395, 0.62297753, 0.62372081,
-	0.62446380, 0.62520650, 0.62594891, 0.62669102,
-	0.62743283, 0.62817434, 0.62891555, 0.62965646,
-	0.63039706, 0.63113735, 0.63187734, 0.63261702,
-	0.63335638, 0.63409543, 0.63483416, 0.63557258,
-	0.63631068, 0.63704845, 0.63778591, 0.63852304,
-	0.63925984, 0.63999632, 0.64073247, 0.64146829,
-	0.64220377, 0.64293892, 0.64367373, 0.64440820,
-	0.64514234, 0.64587613, 0.64660958, 0.64734269,
-	0.64807544, 0.64880785, 0.64953991, 0.65027162,
-	0.65100297, 0.65173397, 0.65246461, 0.65319490,
-	0.65392482, 0.65465438, 0.65538358, 0.65611241,
-	0.65684087, 0.65756896, 0.65829669, 0.65902404,
-	0.65975102, 0.66047762, 0.66120384, 0.66192968,
-	0.66265515, 0.66338023, 0.66410492, 0.66482923,
-	0.66555315, 0.66627668, 0.66699983, 0.66772257,
-	0.66844493, 0.66916688, 0.66988844, 0.67060960,
-	0.67133036, 0.67205071, 0.67277066, 0.67349021,
-	0.67420934, 0.67492806, 0.67564638, 0.67636428,
-	0.67708176, 0.67779883, 0.67851548, 0.67923171,
-	0.67994752, 0.68066290, 0.68137786, 0.68209239,
-	0.68280650, 0.68352017, 0.68423341, 0.68494622,
-	0.68565860, 0.68637053, 0.68708203, 0.68779309,
-	0.68850371, 0.68921388, 0.68992360, 0.69063288,
-	0.69134172, 0.69205010, 0.69275803, 0.69346550,
-	0.69417252, 0.69487909, 0.69558519, 0.69629084,
-	0.69699602, 0.69770074, 0.69840499, 0.69910878,
-	0.69981210, 0.70051495, 0.70121733, 0.70191923,
-	0.70262066, 0.70332161, 0.70402208, 0.70472207,
-	0.70542159, 0.70612061, 0.70681916, 0.70751721,
-	0.70821478, 0.70891186, 0.70960844, 0.71030454,
-	0.71100014, 0.71169524, 0.71238984, 0.71308394,
-	0.71377755, 0.71447065, 0.71516324, 0.71585533,
-	0.71654691, 0.71723798, 0.71792854, 0.71861859,
-	0.71930812, 0.71999714, 0.72068563, 0.72137361,
-	0.72206107, 0.72274801, 0.72343442, 0.72412031,
-	0.72480566, 0.72549049, 0.72617479, 0.72685856,
-	0.72754179, 0.72822449, 0.72890665, 0.72958827,
-	0.73026936, 0.73094990, 0.73162989, 0.73230934,
-	0.73298825, 0.73366660, 0.73434441, 0.73502167,
-	0.73569837, 0.73637452, 0.73705011, 0.73772514,
-	0.73839962, 0.73907353, 0.73974688, 0.74041967,
-	0.74109189, 0.74176354, 0.74243462, 0.74310514,
-	0.74377508, 0.74444445, 0.74511324, 0.74578146,
-	0.74644910, 0.74711615, 0.74778263, 0.74844852,
-	0.74911383, 0.74977856, 0.75044269, 0.75110624,
-	0.75176919, 0.75243155, 0.75309332, 0.75375450,
-	0.75441507, 0.75507505, 0.75573443, 0.75639320,
-	0.75705137, 0.75770894, 0.75836590, 0.75902225,
-	0.75967800, 0.76033313, 0.76098765, 0.76164155,
-	0.76229484, 0.76294751, 0.76359957, 0.76425100,
-	0.76490181, 0.76555200, 0.76620156, 0.76685050,
-	0.76749881, 0.76814649, 0.76879354, 0.76943995,
-	0.77008574, 0.77073088, 0.77137539, 0.77201926,
-	0.77266249, 0.77330508, 0.77394703, 0.77458833,
-	0.77522899, 0.77586899, 0.77650835, 0.77714706,
-	0.77778512, 0.77842252, 0.77905927, 0.77969536,
-	0.78033079, 0.78096556, 0.78159967, 0.78223312,
-	0.78286591, 0.78349802, 0.78412948, 0.78476026,
-	0.78539037, 0.78601981, 0.78664858, 0.78727668,
-	0.78790410, 0.78853084, 0.78915690, 0.78978228,
-	0.79040698, 0.79103100, 0.79165433, 0.79227697,
-	0.79289893, 0.79352020, 0.79414077, 0.79476066,
-	0.79537985, 0.79599835, 0.79661615, 0.79723325,
-	0.79784965, 0.79846535, 0.79908035, 0.79969465,
-	0.80030824, 0.80092112, 0.80153330, 0.80214477,
-	0.80275552, 0.80336556, 0.80397489, 0.80458351,
-	0.80519140, 0.80579858, 0.80640504, 0.80701078,
-	0.80761580, 0.80822009, 0.80882365, 0.80942649,
-	0.81002861, 0.81062999, 0.81123064, 0.81183056,
-	0.81242974, 0.81302819, 0.81362591, 0.81422288,
-	0.81481912, 0.81541461, 0.81600937, 0.81660338,
-	0.81719664, 0.81778916, 0.81838093, 0.81897195,
-	0.81956222, 0.82015174, 0.82074051, 0.82132852,
-	0.82191577, 0.82250227, 0.82308801, 0.82367298,
-	0.82425720, 0.82484065, 0.82542334, 0.82600527,
-	0.82658642, 0.82716681, 0.82774643, 0.82832527,
-	0.82890335, 0.82948065, 0.83005717, 0.83063292,
-	0.83120789, 0.83178208, 0.83235549, 0.83292812,
-	0.83349996, 0.83407102, 0.83464129, 0.83521078,
-	0.83577948, 0.83634738, 0.83691450, 0.83748082,
-	0.83804635, 0.83861109, 0.83917502, 0.83973816,
-	0.84030050, 0.84086204, 0.84142277, 0.84198271,
-	0.84254183, 0.84310016, 0.84365767, 0.84421438,
-	0.84477027, 0.84532536, 0.84587963, 0.84643309,
-	0.84698573, 0.84753756, 0.84808857, 0.84863876,
-	0.84918812, 0.84973667, 0.85028440, 0.85083130,
-	0.85137737, 0.85192262, 0.85246704, 0.85301063,
-	0.85355339, 0.85409532, 0.85463641, 0.85517667,
-	0.85571610, 0.85625469, 0.85679243, 0.85732934,
-	0.85786541, 0.85840064, 0.85893502, 0.85946856,
-	0.86000125, 0.86053310, 0.86106410, 0.86159424,
-	0.86212354, 0.86265199, 0.86317958, 0.86370631,
-	0.86423220, 0.86475722, 0.86528138, 0.86580469,
-	0.86632714, 0.86684872, 0.86736944, 0.86788929,
-	0.86840828, 0.86892641, 0.86944366, 0.86996005,
-	0.87047556, 0.87099021, 0.87150398, 0.87201687,
-	0.87252889, 0.87304004, 0.87355030, 0.87405969,
-	0.87456820, 0.87507582, 0.87558257, 0.87608843,
-	0.87659340, 0.87709749, 0.87760069, 0.87810300,
-	0.87860442, 0.87910495, 0.87960459, 0.88010334,
-	0.88060119, 0.88109815, 0.88159421, 0.88208937,
-	0.88258363, 0.88307700, 0.88356946, 0.88406101,
-	0.88455167, 0.88504142, 0.88553026, 0.88601820,
-	0.88650523, 0.88699135, 0.88747655, 0.88796085,
-	0.88844423, 0.88892670, 0.88940826, 0.88988889,
-	0.89036861, 0.89084742, 0.89132530, 0.89180226,
-	0.89227830, 0.89275341, 0.89322761, 0.89370087,
-	0.89417321, 0.89464463, 0.89511511, 0.89558467,
-	0.89605329, 0.89652098, 0.89698774, 0.89745356,
-	0.89791845, 0.89838241, 0.89884542, 0.89930750,
-	0.89976863, 0.90022883, 0.90068809, 0.90114640,
-	0.90160377, 0.90206019, 0.90251567, 0.90297020,
-	0.90342378, 0.90387641, 0.90432809, 0.90477882,
-	0.90522860, 0.90567742, 0.90612529, 0.90657221,
-	0.90701816, 0.90746316, 0.90790721, 0.90835029,
-	0.90879241, 0.90923356, 0.90967376, 0.91011299,
-	0.91055126, 0.91098856, 0.91142489, 0.91186026,
-	0.91229465, 0.91272808, 0.91316053, 0.91359201,
-	0.91402252, 0.91445206, 0.91488062, 0.91530820,
-	0.91573481, 0.91616043, 0.91658508, 0.91700875,
-	0.91743144, 0.91785314, 0.91827386, 0.91869360,
-	0.91911235, 0.91953012, 0.91994690, 0.92036269,
-	0.92077749, 0.92119130, 0.92160412, 0.92201595,
-	0.92242678, 0.92283662, 0.92324547, 0.92365332,
-	0.92406017, 0.92446603, 0.92487088, 0.92527474,
-	0.92567760, 0.92607945, 0.92648030, 0.92688015,
-	0.92727899, 0.92767683, 0.92807366, 0.92846949,
-	0.92886431, 0.92925811, 0.92965091, 0.93004270,
-	0.93043347, 0.93082323, 0.93121198, 0.93159971,
-	0.93198643, 0.93237213, 0.93275681, 0.93314048,
-	0.93352312, 0.93390475, 0.93428535, 0.93466494,
-	0.93504350, 0.93542103, 0.93579754, 0.93617303,
-	0.93654749, 0.93692092, 0.93729333, 0.93766470,
-	0.93803505, 0.93840436, 0.93877265, 0.93913990,
-	0.93950611, 0.93987130, 0.94023544, 0.94059856,
-	0.94096063, 0.94132167, 0.94168167, 0.94204063,
-	0.94239855, 0.94275543, 0.94311127, 0.94346606,
-	0.94381981, 0.94417252, 0.94452418, 0.94487479,
-	0.94522436, 0.94557288, 0.94592035, 0.94626678,
-	0.94661215, 0.94695647, 0.94729974, 0.94764196,
-	0.94798312, 0.94832324, 0.94866229, 0.94900029,
-	0.94933723, 0.94967312, 0.95000795, 0.95034171,
-	0.95067442, 0.95100607, 0.95133666, 0.95166618,
-	0.95199465, 0.95232205, 0.95264838, 0.95297365,
-	0.95329785, 0.95362099, 0.95394306, 0.95426406,
-	0.95458399, 0.95490285, 0.95522065, 0.95553737,
-	0.95585302, 0.95616759, 0.95648110, 0.95679352,
-	0.95710488, 0.95741516, 0.95772436, 0.95803248,
-	0.95833953, 0.95864550, 0.95895039, 0.95925420,
-	0.95955693, 0.95985857, 0.96015914, 0.96045862,
-	0.96075702, 0.96105433, 0.96135056, 0.96164571,
-	0.96193977, 0.96223274, 0.96252462, 0.96281542,
-	0.96310512, 0.96339374, 0.96368126, 0.96396770,
-	0.96425304, 0.96453729, 0.96482045, 0.96510251,
-	0.96538348, 0.96566335, 0.96594213, 0.96621981,
-	0.96649640, 0.96677189, 0.96704628, 0.96731956,
-	0.96759175, 0.96786284, 0.96813283, 0.96840172,
-	0.96866951, 0.96893619, 0.96920177, 0.96946624,
-	0.96972961, 0.96999188, 0.97025304, 0.97051309,
-	0.97077203, 0.97102987, 0.97128660, 0.97154222,
-	0.97179673, 0.97205013, 0.97230242, 0.97255360,
-	0.97280366, 0.97305262, 0.97330046, 0.97354718,
-	0.97379280, 0.97403729, 0.97428067, 0.97452294,
-	0.97476409, 0.97500412, 0.97524304, 0.97548083,
-	0.97571751, 0.97595307, 0.97618751, 0.97642082,
-	0.97665302, 0.97688409, 0.97711405, 0.97734288,
-	0.97757058, 0.97779717, 0.97802263, 0.97824696,
-	0.97847017, 0.97869225, 0.97891321, 0.97913304,
-	0.97935174, 0.97956931, 0.97978576, 0.98000107,
-	0.98021526, 0.98042832, 0.98064024, 0.98085104,
-	0.98106070, 0.98126923, 0.98147663, 0.98168290,
-	0.98188803, 0.98209203, 0.98229490, 0.98249663,
-	0.98269722, 0.98289668, 0.98309500, 0.98329219,
-	0.98348824, 0.98368315, 0.98387692, 0.98406955,
-	0.98426105, 0.98445140, 0.98464062, 0.98482869,
-	0.98501563, 0.98520142, 0.98538607, 0.98556958,
-	0.98575195, 0.98593317, 0.98611325, 0.98629218,
-	0.98646998, 0.98664662, 0.98682212, 0.98699648,
-	0.98716969, 0.98734176, 0.98751267, 0.98768244,
-	0.98785107, 0.98801854, 0.98818487, 0.98835004,
-	0.98851407, 0.98867695, 0.98883868, 0.98899926,
-	0.98915869, 0.98931696, 0.98947409, 0.98963006,
-	0.98978488, 0.98993855, 0.99009107, 0.99024243,
-	0.99039264, 0.99054170, 0.99068960, 0.99083634,
-	0.99098193, 0.99112637, 0.99126965, 0.99141178,
-	0.99155274, 0.99169256, 0.99183121, 0.99196871,
-	0.99210505, 0.99224023, 0.99237425, 0.99250712,
-	0.99263882, 0.99276937, 0.99289875, 0.99302698,
-	0.99315405, 0.99327996, 0.99340470, 0.99352829,
-	0.99365071, 0.99377197, 0.99389207, 0.99401101,
-	0.99412878, 0.99424540, 0.99436085, 0.99447513,
-	0.99458825, 0.99470021, 0.99481101, 0.99492064,
-	0.99502911, 0.99513641, 0.99524254, 0.99534751,
-	0.99545132, 0.99555396, 0.99565543, 0.99575574,
-	0.99585488, 0.99595285, 0.99604966, 0.99614530,
-	0.99623977, 0.99633307, 0.99642521, 0.99651618,
-	0.99660597, 0.99669461, 0.99678207, 0.99686836,
-	0.99695349, 0.99703744, 0.99712022, 0.99720184,
-	0.99728229, 0.99736156, 0.99743967, 0.99751660,
-	0.99759236, 0.99766696, 0.99774038, 0.99781263,
-	0.99788371, 0.99795361, 0.99802235, 0.99808991,
-	0.99815631, 0.99822153, 0.99828557, 0.99834845,
-	0.99841015, 0.99847068, 0.99853004, 0.99858822,
-	0.99864523, 0.99870106, 0.99875573, 0.99880922,
-	0.99886153, 0.99891268, 0.99896264, 0.99901144,
-	0.99905906, 0.99910550, 0.99915077, 0.99919487,
-	0.99923779, 0.99927954, 0.99932011, 0.99935951,
-	0.99939773, 0.99943477, 0.99947065, 0.99950534,
-	0.99953886, 0.99957121, 0.99960238, 0.99963237,
-	0.99966119, 0.99968884, 0.99971530, 0.99974059,
-	0.99976471, 0.99978765, 0.99980941, 0.99983000,
-	0.99984941, 0.99986764, 0.99988470, 0.99990058,
-	0.99991529, 0.99992882, 0.99994117, 0.99995235,
-	0.99996235, 0.99997117, 0.99997882, 0.99998529,
-	0.99999059, 0.99999471, 0.99999765, 0.99999941,
-	1.0,        0.99999941, 0.99999765, 0.99999471,
-	0.99999059, 0.99998529, 0.99997882, 0.99997117,
-	0.99996235, 0.99995235, 0.99994117, 0.99992882,
-	0.99991529, 0.99990058, 0.99988470, 0.99986764,
-	0.99984941, 0.99983000, 0.99980941, 0.99978765,
-	0.99976471, 0.99974059, 0.99971530, 0.99968884,
-	0.99966119, 0.99963237, 0.99960238, 0.99957121,
-	0.99953886, 0.99950534, 0.99947065, 0.99943477,
-	0.99939773, 0.99935951, 0.99932011, 0.99927954,
-	0.99923779, 0.99919487, 0.99915077, 0.99910550,
-	0.99905906, 0.99901144, 0.99896264, 0.99891268,
-	0.99886153, 0.99880922, 0.99875573, 0.99870106,
-	0.99864523, 0.99858822, 0.99853004, 0.99847068,
-	0.99841015, 0.99834845, 0.99828557, 0.99822153,
-	0.99815631, 0.99808991, 0.99802235, 0.99795361,
-	0.99788371, 0.99781263, 0.99774038, 0.99766696,
-	0.99759236, 0.99751660, 0.99743967, 0.99736156,
-	0.99728229, 0.99720184, 0.99712022, 0.99703744,
-	0.99695349, 0.99686836, 0.99678207, 0.99669461,
-	0.99660597, 0.99651618, 0.99642521, 0.99633307,
-	0.99623977, 0.99614530, 0.99604966, 0.99595285,
-	0.99585488, 0.99575574, 0.99565543, 0.99555396,
-	0.99545132, 0.99534751, 0.99524254, 0.99513641,
-	0.99502911, 0.99492064, 0.99481101, 0.99470021,
-	0.99458825, 0.99447513, 0.99436085, 0.99424540,
-	0.99412878, 0.99401101, 0.99389207, 0.99377197,
-	0.99365071, 0.99352829, 0.99340470, 0.99327996,
-	0.99315405, 0.99302698, 0.99289875, 0.99276937,
-	0.99263882, 0.99250712, 0.99237425, 0.99224023,
-	0.99210505, 0.99196871, 0.99183121, 0.99169256,
-	0.99155274, 0.99141178, 0.99126965, 0.99112637,
-	0.99098193, 0.99083634, 0.99068960, 0.99054170,
-	0.99039264, 0.99024243, 0.99009107, 0.98993855,
-	0.98978488, 0.98963006, 0.98947409, 0.98931696,
-	0.98915869, 0.98899926, 0.98883868, 0.98867695,
-	0.98851407, 0.98835004, 0.98818487, 0.98801854,
-	0.98785107, 0.98768244, 0.98751267, 0.98734176,
-	0.98716969, 0.98699648, 0.98682212, 0.98664662,
-	0.98646998, 0.98629218, 0.98611325, 0.98593317,
-	0.98575195, 0.98556958, 0.98538607, 0.98520142,
-	0.98501563, 0.98482869, 0.98464062, 0.98445140,
-	0.98426105, 0.98406955, 0.98387692, 0.98368315,
-	0.98348824, 0.98329219, 0.98309500, 0.98289668,
-	0.98269722, 0.98249663, 0.98229490, 0.98209203,
-	0.98188803, 0.98168290, 0.98147663, 0.98126923,
-	0.98106070, 0.98085104, 0.98064024, 0.98042832,
-	0.98021526, 0.98000107, 0.97978576, 0.97956931,
-	0.97935174, 0.97913304, 0.97891321, 0.97869225,
-	0.97847017, 0.97824696, 0.97802263, 0.97779717,
-	0.97757058, 0.97734288, 0.97711405, 0.97688409,
-	0.97665302, 0.97642082, 0.97618751, 0.97595307,
-	0.97571751, 0.97548083, 0.97524304, 0.97500412,
-	0.97476409, 0.97452294, 0.97428067, 0.97403729,
-	0.97379280, 0.97354718, 0.97330046, 0.97305262,
-	0.97280366, 0.97255360, 0.97230242, 0.97205013,
-	0.97179673, 0.97154222, 0.97128660, 0.97102987,
-	0.97077203, 0.97051309, 0.97025304, 0.96999188,
-	0.96972961, 0.96946624, 0.96920177, 0.96893619,
-	0.96866951, 0.96840172, 0.96813283, 0.96786284,
-	0.96759175, 0.96731956, 0.96704628, 0.96677189,
-	0.96649640, 0.96621981, 0.96594213, 0.96566335,
-	0.96538348, 0.96510251, 0.96482045, 0.96453729,
-	0.96425304, 0.96396770, 0.96368126, 0.96339374,
-	0.96310512, 0.96281542, 0.96252462, 0.96223274,
-	0.96193977, 0.96164571, 0.96135056, 0.96105433,
-	0.96075702, 0.96045862, 0.96015914, 0.95985857,
-	0.95955693, 0.95925420, 0.95895039, 0.95864550,
-	0.95833953, 0.95803248, 0.95772436, 0.95741516,
-	0.95710488, 0.95679352, 0.95648110, 0.95616759,
-	0.95585302, 0.95553737, 0.95522065, 0.95490285,
-	0.95458399, 0.95426406, 0.95394306, 0.95362099,
-	0.95329785, 0.95297365, 0.95264838, 0.95232205,
-	0.95199465, 0.95166618, 0.95133666, 0.95100607,
-	0.95067442, 0.95034171, 0.95000795, 0.94967312,
-	0.94933723, 0.94900029, 0.94866229, 0.94832324,
-	0.94798312, 0.94764196, 0.94729974, 0.94695647,
-	0.94661215, 0.94626678, 0.94592035, 0.94557288,
-	0.94522436, 0.94487479, 0.94452418, 0.94417252,
-	0.94381981, 0.94346606, 0.94311127, 0.94275543,
-	0.94239855, 0.94204063, 0.94168167, 0.94132167,
-	0.94096063, 0.94059856, 0.94023544, 0.93987130,
-	0.93950611, 0.93913990, 0.93877265, 0.93840436,
-	0.93803505, 0.93766470, 0.93729333, 0.93692092,
-	0.93654749, 0.93617303, 0.93579754, 0.93542103,
-	0.93504350, 0.93466494, 0.93428535, 0.93390475,
-	0.93352312, 0.93314048, 0.93275681, 0.93237213,
-	0.93198643, 0.93159971, 0.93121198, 0.93082323,
-	0.93043347, 0.93004270, 0.92965091, 0.92925811,
-	0.92886431, 0.92846949, 0.92807366, 0.92767683,
-	0.92727899, 0.92688015, 0.92648030, 0.92607945,
-	0.92567760, 0.92527474, 0.92487088, 0.92446603,
-	0.92406017, 0.92365332, 0.92324547, 0.92283662,
-	0.92242678, 0.92201595, 0.92160412, 0.92119130,
-	0.92077749, 0.92036269, 0.91994690, 0.91953012,
-	0.91911235, 0.91869360, 0.91827386, 0.91785314,
-	0.91743144, 0.91700875, 0.91658508, 0.91616043,
-	0.91573481, 0.91530820, 0.91488062, 0.91445206,
-	0.91402252, 0.91359201, 0.91316053, 0.91272808,
-	0.91229465, 0.91186026, 0.91142489, 0.91098856,
-	0.91055126, 0.91011299, 0.90967376, 0.90923356,
-	0.90879241, 0.90835029, 0.90790721, 0.90746316,
-	0.90701816, 0.90657221, 0.90612529, 0.90567742,
-	0.90522860, 0.90477882, 0.90432809, 0.90387641,
-	0.90342378, 0.90297020, 0.90251567, 0.90206019,
-	0.90160377, 0.90114640, 0.90068809, 0.90022883,
-	0.89976863, 0.89930750, 0.89884542, 0.89838241,
-	0.89791845, 0.89745356, 0.89698774, 0.89652098,
-	0.89605329, 0.89558467, 0.89511511, 0.89464463,
-	0.89417321, 0.89370087, 0.89322761, 0.89275341,
-	0.89227830, 0.89180226, 0.89132530, 0.89084742,
-	0.89036861, 0.88988889, 0.88940826, 0.88892670,
-	0.88844423, 0.88796085, 0.88747655, 0.88699135,
-	0.88650523, 0.88601820, 0.88553026, 0.88504142,
-	0.88455167, 0.88406101, 0.88356946, 0.88307700,
-	0.88258363, 0.88208937, 0.88159421, 0.88109815,
-	0.88060119, 0.88010334, 0.87960459, 0.87910495,
-	0.87860442, 0.87810300, 0.87760069, 0.87709749,
-	0.87659340, 0.87608843, 0.87558257, 0.87507582,
-	0.87456820, 0.87405969, 0.87355030, 0.87304004,
-	0.87252889, 0.87201687, 0.87150398, 0.87099021,
-	0.87047556, 0.86996005, 0.86944366, 0.86892641,
-	0.86840828, 0.86788929, 0.86736944, 0.86684872,
-	0.86632714, 0.86580469, 0.86528138, 0.86475722,
-	0.86423220, 0.86370631, 0.86317958, 0.86265199,
-	0.86212354, 0.86159424, 0.86106410, 0.86053310,
-	0.86000125, 0.85946856, 0.85893502, 0.85840064,
-	0.85786541, 0.85732934, 0.85679243, 0.85625469,
-	0.85571610, 0.85517667, 0.85463641, 0.85409532,
-	0.85355339, 0.85301063, 0.85246704, 0.85192262,
-	0.85137737, 0.85083130, 0.85028440, 0.84973667,
-	0.84918812, 0.84863876, 0.84808857, 0.84753756,
-	0.84698573, 0.84643309, 0.84587963, 0.84532536,
-	0.84477027, 0.84421438, 0.84365767, 0.84310016,
-	0.84254183, 0.84198271, 0.84142277, 0.84086204,
-	0.84030050, 0.83973816, 0.83917502, 0.83861109,
-	0.83804635, 0.83748082, 0.83691450, 0.83634738,
-	0.83577948, 0.83521078, 0.83464129, 0.83407102,
-	0.83349996, 0.83292812, 0.83235549, 0.83178208,
-	0.83120789, 0.83063292, 0.83005717, 0.82948065,
-	0.82890335, 0.82832527, 0.82774643, 0.82716681,
-	0.82658642, 0.82600527, 0.82542334, 0.82484065,
-	0.82425720, 0.82367298, 0.82308801, 0.82250227,
-	0.82191577, 0.82132852, 0.82074051, 0.82015174,
-	0.81956222, 0.81897195, 0.81838093, 0.81778916,
-	0.81719664, 0.81660338, 0.81600937, 0.81541461,
-	0.81481912, 0.81422288, 0.81362591, 0.81302819,
-	0.81242974, 0.81183056, 0.81123064, 0.81062999,
-	0.81002861, 0.80942649, 0.80882365, 0.80822009,
-	0.80761580, 0.80701078, 0.80640504, 0.80579858,
-	0.80519140, 0.80458351, 0.80397489, 0.80336556,
-	0.80275552, 0.80214477, 0.80153330, 0.80092112,
-	0.80030824, 0.79969465, 0.79908035, 0.79846535,
-	0.79784965, 0.79723325, 0.79661615, 0.79599835,
-	0.79537985, 0.79476066, 0.79414077, 0.79352020,
-	0.79289893, 0.79227697, 0.79165433, 0.79103100,
-	0.79040698, 0.78978228, 0.78915690, 0.78853084,
-	0.78790410, 0.78727668, 0.78664858, 0.78601981,
-	0.78539037, 0.78476026, 0.78412948, 0.78349802,
-	0.78286591, 0.78223312, 0.78159967, 0.78096556,
-	0.78033079, 0.77969536, 0.77905927, 0.77842252,
-	0.77778512, 0.77714706, 0.77650835, 0.77586899,
-	0.77522899, 0.77458833, 0.77394703, 0.77330508,
-	0.77266249, 0.77201926, 0.77137539, 0.77073088,
-	0.77008574, 0.76943995, 0.76879354, 0.76814649,
-	0.76749881, 0.76685050, 0.76620156, 0.76555200,
-	0.76490181, 0.76425100, 0.76359957, 0.76294751,
-	0.76229484, 0.76164155, 0.76098765, 0.76033313,
-	0.75967800, 0.75902225, 0.75836590, 0.75770894,
-	0.75705137, 0.75639320, 0.75573443, 0.75507505,
-	0.75441507, 0.75375450, 0.75309332, 0.75243155,
-	0.75176919, 0.75110624, 0.75044269, 0.74977856,
-	0.74911383, 0.74844852, 0.74778263, 0.74711615,
-	0.74644910, 0.74578146, 0.74511324, 0.74444445,
-	0.74377508, 0.74310514, 0.74243462, 0.74176354,
-	0.74109189, 0.74041967, 0.73974688, 0.73907353,
-	0.73839962, 0.73772514, 0.73705011, 0.73637452,
-	0.73569837, 0.73502167, 0.73434441, 0.73366660,
-	0.73298825, 0.73230934, 0.73162989, 0.73094990,
-	0.73026936, 0.72958827, 0.72890665, 0.72822449,
-	0.72754179, 0.72685856, 0.72617479, 0.72549049,
-	0.72480566, 0.72412031, 0.72343442, 0.72274801,
-	0.72206107, 0.72137361, 0.72068563, 0.71999714,
-	0.71930812, 0.71861859, 0.71792854, 0.71723798,
-	0.71654691, 0.71585533, 0.71516324, 0.71447065,
-	0.71377755, 0.71308394, 0.71238984, 0.71169524,
-	0.71100014, 0.71030454, 0.70960844, 0.70891186,
-	0.70821478, 0.70751721, 0.70681916, 0.70612061,
-	0.70542159, 0.70472207, 0.70402208, 0.70332161,
-	0.70262066, 0.70191923, 0.70121733, 0.70051495,
-	0.69981210, 0.69910878, 0.69840499, 0.69770074,
-	0.69699602, 0.69629084, 0.69558519, 0.69487909,
-	0.69417252, 0.69346550, 0.69275803, 0.69205010,
-	0.69134172, 0.69063288, 0.68992360, 0.68921388,
-	0.68850371, 0.68779309, 0.68708203, 0.68637053,
-	0.68565860, 0.68494622, 0.68423341, 0.68352017,
-	0.68280650, 0.68209239, 0.68137786, 0.68066290,
-	0.67994752, 0.67923171, 0.67851548, 0.67779883,
-	0.67708176, 0.67636428, 0.67564638, 0.67492806,
-	0.67420934, 0.67349021, 0.67277066, 0.67205071,
-	0.67133036, 0.67060960, 0.66988844, 0.66916688,
-	0.66844493, 0.66772257, 0.66699983, 0.66627668,
-	0.66555315, 0.66482923, 0.66410492, 0.66338023,
-	0.66265515, 0.66192968, 0.66120384, 0.66047762,
-	0.65975102, 0.65902404, 0.65829669, 0.65756896,
-	0.65684087, 0.65611241, 0.65538358, 0.65465438,
-	0.65392482, 0.65319490, 0.65246461, 0.65173397,
-	0.65100297, 0.65027162, 0.64953991, 0.64880785,
-	0.64807544, 0.64734269, 0.64660958, 0.64587613,
-	0.64514234, 0.64440820, 0.64367373, 0.64293892,
-	0.64220377, 0.64146829, 0.64073247, 0.63999632,
-	0.63925984, 0.63852304, 0.63778591, 0.63704845,
-	0.63631068, 0.63557258, 0.63483416, 0.63409543,
-	0.63335638, 0.63261702, 0.63187734, 0.63113735,
-	0.63039706, 0.62965646, 0.62891555, 0.62817434,
-	0.62743283, 0.62669102, 0.62594891, 0.62520650,
-	0.62446380, 0.62372081, 0.62297753, 0.62223395,
-	0.62149009, 0.62074594, 0.62000151, 0.61925680,
-	0.61851180, 0.61776653, 0.61702098, 0.61627515,
-	0.61552905, 0.61478268, 0.61403604, 0.61328913,
-	0.61254196, 0.61179451, 0.61104681, 0.61029885,
-	0.60955062, 0.60880214, 0.60805340, 0.60730441,
-	0.60655516, 0.60580566, 0.60505592, 0.60430593,
-	0.60355569, 0.60280521, 0.60205448, 0.60130352,
-	0.60055232, 0.59980088, 0.59904921, 0.59829730,
-	0.59754516, 0.59679279, 0.59604020, 0.59528738,
-	0.59453433, 0.59378106, 0.59302758, 0.59227387,
-	0.59151994, 0.59076580, 0.59001145, 0.58925689,
-	0.58850211, 0.58774713, 0.58699194, 0.58623654,
-	0.58548094, 0.58472515, 0.58396915, 0.58321295,
-	0.58245656, 0.58169997, 0.58094320, 0.58018623,
-	0.57942907, 0.57867173, 0.57791420, 0.57715649,
-	0.57639859, 0.57564052, 0.57488227, 0.57412384,
-	0.57336524, 0.57260646, 0.57184752, 0.57108840,
-	0.57032912, 0.56956967, 0.56881006, 0.56805029,
-	0.56729035, 0.56653026, 0.56577001, 0.56500961,
-	0.56424906, 0.56348835, 0.56272749, 0.56196649,
-	0.56120534, 0.56044404, 0.55968261, 0.55892103,
-	0.55815932, 0.55739746, 0.55663548, 0.55587336,
-	0.55511110, 0.55434872, 0.55358621, 0.55282358,
-	0.55206082, 0.55129793, 0.55053493, 0.54977181,
-	0.54900857, 0.54824522, 0.54748175, 0.54671817,
-	0.54595448, 0.54519068, 0.54442678, 0.54366277,
-	0.54289866, 0.54213444, 0.54137013, 0.54060572,
-	0.53984122, 0.53907662, 0.53831193, 0.53754715,
-	0.53678228, 0.53601733, 0.53525229, 0.53448716,
-	0.53372196, 0.53295668, 0.53219132, 0.53142588,
-	0.53066037, 0.52989479, 0.52912913, 0.52836341,
-	0.52759762, 0.52683177, 0.52606585, 0.52529987,
-	0.52453384, 0.52376774, 0.52300159, 0.52223539,
-	0.52146913, 0.52070282, 0.51993646, 0.51917006,
-	0.51840361, 0.51763712, 0.51687059, 0.51610401,
-	0.51533740, 0.51457075, 0.51380407, 0.51303736,
-	0.51227061, 0.51150384, 0.51073704, 0.50997021,
-	0.50920336, 0.50843649, 0.50766960, 0.50690269,
-	0.50613577, 0.50536883, 0.50460188, 0.50383491,
-	0.50306794, 0.50230096, 0.50153398, 0.50076699,
-	0.50000000, 0.49923301, 0.49846602, 0.49769904,
-	0.49693206, 0.49616509, 0.49539812, 0.49463117,
-	0.49386423, 0.49309731, 0.49233040, 0.49156351,
-	0.49079664, 0.49002979, 0.48926296, 0.48849616,
-	0.48772939, 0.48696264, 0.48619593, 0.48542925,
-	0.48466260, 0.48389599, 0.48312941, 0.48236288,
-	0.48159639, 0.48082994, 0.48006354, 0.47929718,
-	0.47853087, 0.47776461, 0.47699841, 0.47623226,
-	0.47546616, 0.47470013, 0.47393415, 0.47316823,
-	0.47240238, 0.47163659, 0.47087087, 0.47010521,
-	0.46933963, 0.46857412, 0.46780868, 0.46704332,
-	0.46627804, 0.46551284, 0.46474771, 0.46398267,
-	0.46321772, 0.46245285, 0.46168807, 0.46092338,
-	0.46015878, 0.45939428, 0.45862987, 0.45786556,
-	0.45710134, 0.45633723, 0.45557322, 0.45480932,
-	0.45404552, 0.45328183, 0.45251825, 0.45175478,
-	0.45099143, 0.45022819, 0.44946507, 0.44870207,
-	0.44793918, 0.44717642, 0.44641379, 0.44565128,
-	0.44488890, 0.44412664, 0.44336452, 0.44260254,
-	0.44184068, 0.44107897, 0.44031739, 0.43955596,
-	0.43879466, 0.43803351, 0.43727251, 0.43651165,
-	0.43575094, 0.43499039, 0.43422999, 0.43346974,
-	0.43270965, 0.43194971, 0.43118994, 0.43043033,
-	0.42967088, 0.42891160, 0.42815248, 0.42739354,
-	0.42663476, 0.42587616, 0.42511773, 0.42435948,
-	0.42360141, 0.42284351, 0.42208580, 0.42132827,
-	0.42057093, 0.41981377, 0.41905680, 0.41830003,
-	0.41754344, 0.41678705, 0.41603085, 0.41527485,
-	0.41451906, 0.41376346, 0.41300806, 0.41225287,
-	0.41149789, 0.41074311, 0.40998855, 0.40923420,
-	0.40848006, 0.40772613, 0.40697242, 0.40621894,
-	0.40546567, 0.40471262, 0.40395980, 0.40320721,
-	0.40245484, 0.40170270, 0.40095079, 0.40019912,
-	0.39944768, 0.39869648, 0.39794552, 0.39719479,
-	0.39644431, 0.39569407, 0.39494408, 0.39419434,
-	0.39344484, 0.39269559, 0.39194660, 0.39119786,
-	0.39044938, 0.38970115, 0.38895319, 0.38820549,
-	0.38745804, 0.38671087, 0.38596396, 0.38521732,
-	0.38447095, 0.38372485, 0.38297902, 0.38223347,
-	0.38148820, 0.38074320, 0.37999849, 0.37925406,
-	0.37850991, 0.37776605, 0.37702247, 0.37627919,
-	0.37553620, 0.37479350, 0.37405109, 0.37330898,
-	0.37256717, 0.37182566, 0.37108445, 0.37034354,
-	0.36960294, 0.36886265, 0.36812266, 0.36738298,
-	0.36664362, 0.36590457, 0.36516584, 0.36442742,
-	0.36368932, 0.36295155, 0.36221409, 0.36147696,
-	0.36074016, 0.36000368, 0.35926753, 0.35853171,
-	0.35779623, 0.35706108, 0.35632627, 0.35559180,
-	0.35485766, 0.35412387, 0.35339042, 0.35265731,
-	0.35192456, 0.35119215, 0.35046009, 0.34972838,
-	0.34899703, 0.34826603, 0.34753539, 0.34680510,
-	0.34607518, 0.34534562, 0.34461642, 0.34388759,
-	0.34315913, 0.34243104, 0.34170331, 0.34097596,
-	0.34024898, 0.33952238, 0.33879616, 0.33807032,
-	0.33734485, 0.33661977, 0.33589508, 0.33517077,
-	0.33444685, 0.33372332, 0.33300017, 0.33227743,
-	0.33155507, 0.33083312, 0.33011156, 0.32939040,
-	0.32866964, 0.32794929, 0.32722934, 0.32650979,
-	0.32579066, 0.32507194, 0.32435362, 0.32363572,
-	0.32291824, 0.32220117, 0.32148452, 0.32076829,
-	0.32005248, 0.31933710, 0.31862214, 0.31790761,
-	0.31719350, 0.31647983, 0.31576659, 0.31505378,
-	0.31434140, 0.31362947, 0.31291797, 0.31220691,
-	0.31149629, 0.31078612, 0.31007640, 0.30936712,
-	0.30865828, 0.30794990, 0.30724197, 0.30653450,
-	0.30582748, 0.30512091, 0.30441481, 0.30370916,
-	0.30300398, 0.30229926, 0.30159501, 0.30089122,
-	0.30018790, 0.29948505, 0.29878267, 0.29808077,
-	0.29737934, 0.29667839, 0.29597792, 0.29527793,
-	0.29457841, 0.29387939, 0.29318084, 0.29248279,
-	0.29178522, 0.29108814, 0.29039156, 0.28969546,
-	0.28899986, 0.28830476, 0.28761016, 0.28691606,
-	0.28622245, 0.28552935, 0.28483676, 0.28414467,
-	0.28345309, 0.28276202, 0.28207146, 0.28138141,
-	0.28069188, 0.28000286, 0.27931437, 0.27862639,
-	0.27793893, 0.27725199, 0.27656558, 0.27587969,
-	0.27519434, 0.27450951, 0.27382521, 0.27314144,
-	0.27245821, 0.27177551, 0.27109335, 0.27041173,
-	0.26973064, 0.26905010, 0.26837011, 0.26769066,
-	0.26701175, 0.26633340, 0.26565559, 0.26497833,
-	0.26430163, 0.26362548, 0.26294989, 0.26227486,
-	0.26160038, 0.26092647, 0.26025312, 0.25958033,
-	0.25890811, 0.25823646, 0.25756538, 0.25689486,
-	0.25622492, 0.25555555, 0.25488676, 0.25421854,
-	0.25355090, 0.25288385, 0.25221737, 0.25155148,
-	0.25088617, 0.25022144, 0.24955731, 0.24889376,
-	0.24823081, 0.24756845, 0.24690668, 0.24624550,
-	0.24558493, 0.24492495, 0.24426557, 0.24360680,
-	0.24294863, 0.24229106, 0.24163410, 0.24097775,
-	0.24032200, 0.23966687, 0.23901235, 0.23835845,
-	0.23770516, 0.23705249, 0.23640043, 0.23574900,
-	0.23509819, 0.23444800, 0.23379844, 0.23314950,
-	0.23250119, 0.23185351, 0.23120646, 0.23056005,
-	0.22991426, 0.22926912, 0.22862461, 0.22798074,
-	0.22733751, 0.22669492, 0.22605297, 0.22541167,
-	0.22477101, 0.22413101, 0.22349165, 0.22285294,
-	0.22221488, 0.22157748, 0.22094073, 0.22030464,
-	0.21966921, 0.21903444, 0.21840033, 0.21776688,
-	0.21713409, 0.21650198, 0.21587052, 0.21523974,
-	0.21460963, 0.21398019, 0.21335142, 0.21272332,
-	0.21209590, 0.21146916, 0.21084310, 0.21021772,
-	0.20959302, 0.20896900, 0.20834567, 0.20772303,
-	0.20710107, 0.20647980, 0.20585923, 0.20523934,
-	0.20462015, 0.20400165, 0.20338385, 0.20276675,
-	0.20215035, 0.20153465, 0.20091965, 0.20030535,
-	0.19969176, 0.19907888, 0.19846670, 0.19785523,
-	0.19724448, 0.19663444, 0.19602511, 0.19541649,
-	0.19480860, 0.19420142, 0.19359496, 0.19298922,
-	0.19238420, 0.19177991, 0.19117635, 0.19057351,
-	0.18997139, 0.18937001, 0.18876936, 0.18816944,
-	0.18757026, 0.18697181, 0.18637409, 0.18577712,
-	0.18518088, 0.18458539, 0.18399063, 0.18339662,
-	0.18280336, 0.18221084, 0.18161907, 0.18102805,
-	0.18043778, 0.17984826, 0.17925949, 0.17867148,
-	0.17808423, 0.17749773, 0.17691199, 0.17632702,
-	0.17574280, 0.17515935, 0.17457666, 0.17399473,
-	0.17341358, 0.17283319, 0.17225357, 0.17167473,
-	0.17109665, 0.17051935, 0.16994283, 0.16936708,
-	0.16879211, 0.16821792, 0.16764451, 0.16707188,
-	0.16650004, 0.16592898, 0.16535871, 0.16478922,
-	0.16422052, 0.16365262, 0.16308550, 0.16251918,
-	0.16195365, 0.16138891, 0.16082498, 0.16026184,
-	0.15969950, 0.15913796, 0.15857723, 0.15801729,
-	0.15745817, 0.15689984, 0.15634233, 0.15578562,
-	0.15522973, 0.15467464, 0.15412037, 0.15356691,
-	0.15301427, 0.15246244, 0.15191143, 0.15136124,
-	0.15081188, 0.15026333, 0.14971560, 0.14916870,
-	0.14862263, 0.14807738, 0.14753296, 0.14698937,
-	0.14644661, 0.14590468, 0.14536359, 0.14482333,
-	0.14428390, 0.14374531, 0.14320757, 0.14267066,
-	0.14213459, 0.14159936, 0.14106498, 0.14053144,
-	0.13999875, 0.13946690, 0.13893590, 0.13840576,
-	0.13787646, 0.13734801, 0.13682042, 0.13629369,
-	0.13576780, 0.13524278, 0.13471862, 0.13419531,
-	0.13367286, 0.13315128, 0.13263056, 0.13211071,
-	0.13159172, 0.13107359, 0.13055634, 0.13003995,
-	0.12952444, 0.12900979, 0.12849602, 0.12798313,
-	0.12747111, 0.12695996, 0.12644970, 0.12594031,
-	0.12543180, 0.12492418, 0.12441743, 0.12391157,
-	0.12340660, 0.12290251, 0.12239931, 0.12189700,
-	0.12139558, 0.12089505, 0.12039541, 0.11989666,
-	0.11939881, 0.11890185, 0.11840579, 0.11791063,
-	0.11741637, 0.11692300, 0.11643054, 0.11593899,
-	0.11544833, 0.11495858, 0.11446974, 0.11398180,
-	0.11349477, 0.11300865, 0.11252345, 0.11203915,
-	0.11155577, 0.11107330, 0.11059174, 0.11011111,
-	0.10963139, 0.10915258, 0.10867470, 0.10819774,
-	0.10772170, 0.10724659, 0.10677239, 0.10629913,
-	0.10582679, 0.10535537, 0.10488489, 0.10441533,
-	0.10394671, 0.10347902, 0.10301226, 0.10254644,
-	0.10208155, 0.10161759, 0.10115458, 0.10069250,
-	0.10023137, 0.09977117, 0.09931191, 0.09885360,
-	0.09839623, 0.09793981, 0.09748433, 0.09702980,
-	0.09657622, 0.09612359, 0.09567191, 0.09522118,
-	0.09477140, 0.09432258, 0.09387471, 0.09342779,
-	0.09298184, 0.09253684, 0.09209279, 0.09164971,
-	0.09120759, 0.09076644, 0.09032624, 0.08988701,
-	0.08944874, 0.08901144, 0.08857511, 0.08813974,
-	0.08770535, 0.08727192, 0.08683947, 0.08640799,
-	0.08597748, 0.08554794, 0.08511938, 0.08469180,
-	0.08426519, 0.08383957, 0.08341492, 0.08299125,
-	0.08256856, 0.08214686, 0.08172614, 0.08130640,
-	0.08088765, 0.08046988, 0.08005310, 0.07963731,
-	0.07922251, 0.07880870, 0.07839588, 0.07798405,
-	0.07757322, 0.07716338, 0.07675453, 0.07634668,
-	0.07593983, 0.07553397, 0.07512912, 0.07472526,
-	0.07432240, 0.07392055, 0.07351970, 0.07311985,
-	0.07272101, 0.07232317, 0.07192634, 0.07153051,
-	0.07113569, 0.07074189, 0.07034909, 0.06995730,
-	0.06956653, 0.06917677, 0.06878802, 0.06840029,
-	0.06801357, 0.06762787, 0.06724319, 0.06685952,
-	0.06647688, 0.06609525, 0.06571465, 0.06533506,
-	0.06495650, 0.06457897, 0.06420246, 0.06382697,
-	0.06345251, 0.06307908, 0.06270667, 0.06233530,
-	0.06196495, 0.06159564, 0.06122735, 0.06086010,
-	0.06049389, 0.06012870, 0.05976456, 0.05940144,
-	0.05903937, 0.05867833, 0.05831833, 0.05795937,
-	0.05760145, 0.05724457, 0.05688873, 0.05653394,
-	0.05618019, 0.05582748, 0.05547582, 0.05512521,
-	0.05477564, 0.05442712, 0.05407965, 0.05373322,
-	0.05338785, 0.05304353, 0.05270026, 0.05235804,
-	0.05201688, 0.05167676, 0.05133771, 0.05099971,
-	0.05066277, 0.05032688, 0.04999205, 0.04965829,
-	0.04932558, 0.04899393, 0.04866334, 0.04833382,
-	0.04800535, 0.04767795, 0.04735162, 0.04702635,
-	0.04670215, 0.04637901, 0.04605694, 0.04573594,
-	0.04541601, 0.04509715, 0.04477935, 0.04446263,
-	0.04414698, 0.04383241, 0.04351890, 0.04320648,
-	0.04289512, 0.04258484, 0.04227564, 0.04196752,
-	0.04166047, 0.04135450, 0.04104961, 0.04074580,
-	0.04044307, 0.04014143, 0.03984086, 0.03954138,
-	0.03924298, 0.03894567, 0.03864944, 0.03835429,
-	0.03806023, 0.03776726, 0.03747538, 0.03718458,
-	0.03689488, 0.03660626, 0.03631874, 0.03603230,
-	0.03574696, 0.03546271, 0.03517955, 0.03489749,
-	0.03461652, 0.03433665, 0.03405787, 0.03378019,
-	0.03350360, 0.03322811, 0.03295372, 0.03268044,
-	0.03240825, 0.03213716, 0.03186717, 0.03159828,
-	0.03133049, 0.03106381, 0.03079823, 0.03053376,
-	0.03027039, 0.03000812, 0.02974696, 0.02948691,
-	0.02922797, 0.02897013, 0.02871340, 0.02845778,
-	0.02820327, 0.02794987, 0.02769758, 0.02744640,
-	0.02719634, 0.02694738, 0.02669954, 0.02645282,
-	0.02620720, 0.02596271, 0.02571933, 0.02547706,
-	0.02523591, 0.02499588, 0.02475696, 0.02451917,
-	0.02428249, 0.02404693, 0.02381249, 0.02357918,
-	0.02334698, 0.02311591, 0.02288595, 0.02265712,
-	0.02242942, 0.02220283, 0.02197737, 0.02175304,
-	0.02152983, 0.02130775, 0.02108679, 0.02086696,
-	0.02064826, 0.02043069, 0.02021424, 0.01999893,
-	0.01978474, 0.01957168, 0.01935976, 0.01914896,
-	0.01893930, 0.01873077, 0.01852337, 0.01831710,
-	0.01811197, 0.01790797, 0.01770510, 0.01750337,
-	0.01730278, 0.01710332, 0.01690500, 0.01670781,
-	0.01651176, 0.01631685, 0.01612308, 0.01593045,
-	0.01573895, 0.01554860, 0.01535938, 0.01517131,
-	0.01498437, 0.01479858, 0.01461393, 0.01443042,
-	0.01424805, 0.01406683, 0.01388675, 0.01370782,
-	0.01353002, 0.01335338, 0.01317788, 0.01300352,
-	0.01283031, 0.01265824, 0.01248733, 0.01231756,
-	0.01214893, 0.01198146, 0.01181513, 0.01164996,
-	0.01148593, 0.01132305, 0.01116132, 0.01100074,
-	0.01084131, 0.01068304, 0.01052591, 0.01036994,
-	0.01021512, 0.01006145, 0.00990893, 0.00975757,
-	0.00960736, 0.00945830, 0.00931040, 0.00916366,
-	0.00901807, 0.00887363, 0.00873035, 0.00858822,
-	0.00844726, 0.00830744, 0.00816879, 0.00803129,
-	0.00789495, 0.00775977, 0.00762575, 0.00749288,
-	0.00736118, 0.00723063, 0.00710125, 0.00697302,
-	0.00684595, 0.00672004, 0.00659530, 0.00647171,
-	0.00634929, 0.00622803, 0.00610793, 0.00598899,
-	0.00587122, 0.00575460, 0.00563915, 0.00552487,
-	0.00541175, 0.00529979, 0.00518899, 0.00507936,
-	0.00497089, 0.00486359, 0.00475746, 0.00465249,
-	0.00454868, 0.00444604, 0.00434457, 0.00424426,
-	0.00414512, 0.00404715, 0.00395034, 0.00385470,
-	0.00376023, 0.00366693, 0.00357479, 0.00348382,
-	0.00339403, 0.00330539, 0.00321793, 0.00313164,
-	0.00304651, 0.00296256, 0.00287978, 0.00279816,
-	0.00271771, 0.00263844, 0.00256033, 0.00248340,
-	0.00240764, 0.00233304, 0.00225962, 0.00218737,
-	0.00211629, 0.00204639, 0.00197765, 0.00191009,
-	0.00184369, 0.00177847, 0.00171443, 0.00165155,
-	0.00158985, 0.00152932, 0.00146996, 0.00141178,
-	0.00135477, 0.00129894, 0.00124427, 0.00119078,
-	0.00113847, 0.00108732, 0.00103736, 0.00098856,
-	0.00094094, 0.00089450, 0.00084923, 0.00080513,
-	0.00076221, 0.00072046, 0.00067989, 0.00064049,
-	0.00060227, 0.00056523, 0.00052935, 0.00049466,
-	0.00046114, 0.00042879, 0.00039762, 0.00036763,
-	0.00033881, 0.00031116, 0.00028470, 0.00025941,
-	0.00023529, 0.00021235, 0.00019059, 0.00017000,
-	0.00015059, 0.00013236, 0.00011530, 0.00009942,
-	0.00008471, 0.00007118, 0.00005883, 0.00004765,
-	0.00003765, 0.00002883, 0.00002118, 0.00001471,
-	0.00000941, 0.00000529, 0.00000235, 0.00000059
-};
-
-#endif
@@ -0,0 +1,1758 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <fftw3.h>
+
+#include "vochorus.h"
+#include "chorus_scales.h"
+
+#define WISDOM_DIR  "/.config/warpy"
+#define WISDOM_FILE "/warpy.wis"
+
+// how far off 1 the pitch can be and still count as unchanged
+#define UNITY_PITCH_TOLERANCE 1e-9
+// how far either way a stretched grain can move to line up with the last
+// one, and how much of it is compared to find where
+#define WSOLA_MAX_REACH 256
+#define WSOLA_MAX_SPAN  512
+#define WSOLA_STRIDE    4
+
+// the onset detector's own small FFT, its adaptive threshold over the
+// frames either side, in average log magnitude rise per bin since samples
+// are normalized on load, and how close together two onsets can be
+#define ONSET_FFT_SIZE     1024
+#define ONSET_HOP          256
+#define ONSET_MEAN_FRAMES  8
+#define ONSET_PEAK_FRAMES  3
+#define ONSET_DELTA        0.1
+#define ONSET_MIN_GAP_SECS 0.03
+
+// the envelope analysis's FFT and frame spacing, how many cepstral
+// coefficients the lifter keeps, which is what smooths harmonics out of
+// the envelope, and how far a bin can be pushed to meet it, so that a
+// deep valley doesn't turn into a huge boost
+#define ENVELOPE_FFT_SIZE 1024
+#define ENVELOPE_HOP      512
+#define ENVELOPE_CEPSTRA  40
+#define ENVELOPE_FLOOR    1e-6
+#define ENVELOPE_MAX_GAIN 8.0
+#define ENVELOPE_STRIDE   (ENVELOPE_FFT_SIZE / 2 / (VOCHORUS_ENVELOPE_BINS - 1))
+
+static const size_t   max_chorus_scale_val = CHORUS_SCALES_LEN - 1;
+static const double   threeqtr_pi          = M_PI_4 * 3;
+
+struct warpy_chorus_voice {
+	double*             fwin;
+	double*             bwin;
+	double*             pwin;
+	struct fftw_plan_s* fft_fwin_forw;
+	struct fftw_plan_s* fft_fwin_back;
+	struct fftw_plan_s* fft_bwin_forw;
+};
+
+static const double max_detunes[MAX_CHORUS_VOICES] = {
+	0.1191221,  -0.11952356,
+	0.16216538, -0.16288439,
+	0.21045242, -0.20702313
+};
+
+static const double max_pans[MAX_CHORUS_VOICES] = {
+	0.75,        0.25,
+	1.0/3.0,     2.0/3.0,
+	0.5,         0.5
+};
+
+// only the audio thread takes machinery, and only a thread that can wait
+// for the planner replans it, so the two claim it in turn
+#define MACH_FREE     0
+#define MACH_IN_USE   1
+#define MACH_RESIZING 2
+
+// a cache line, and the per-voice constants rounded up to whole ones
+#define ARENA_ALIGN     64
+#define ARENA_CONSTANTS ((2 * MAX_CHORUS_VOICES * sizeof(double) + \
+                          ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN / \
+                         sizeof(double))
+
+// everything a frame touches comes out of one arena, in the order a frame
+// goes through it: the per-voice constants, the window, fwin, bwin and
+// pwin for the main voice and then each chorus voice, and the out frames;
+// every array is fft_size doubles, so they all start on a cache line
+struct warpy_fft_machinery {
+	int      state;
+	unsigned fft_size;
+	double*  arena;
+	double*  max_detune;
+	double*  max_pan;
+	double*  window;
+	double* fwin;
+	double* bwin;
+	double* pwin;
+	struct  fftw_plan_s*  fft_fwin_forw;
+	struct  fftw_plan_s*  fft_fwin_back;
+	struct  fftw_plan_s*  fft_bwin_forw;
+	struct  warpy_chorus_voice chor_voices[MAX_CHORUS_VOICES];
+	// lent to whichever vochorus holds the machinery, so that no note has
+	// to allocate its own
+	struct  vochorus_frames frames;
+};
+
+// the FFTW planner isn't thread-safe, and several Warpy instances may be
+// planning at once
+static pthread_mutex_t planner_lock = PTHREAD_MUTEX_INITIALIZER;
+
+unsigned check_vochorus_fft_size(const double fft_size_arg)
+{
+	if (fft_size_arg <= 0)
+		return DEFAULT_FFT_SIZE;
+
+	unsigned fft_size = MIN_FFT_SIZE;
+	while (fft_size < MAX_FFT_SIZE && fft_size < fft_size_arg)
+		fft_size <<= 1;
+	return fft_size;
+}
+
+unsigned check_vochorus_overlap(const double overlap_arg)
+{
+	if (overlap_arg <= 0)
+		return DEFAULT_OVERLAP;
+
+	// the hop size has to divide the FFT size evenly
+	unsigned overlap = MIN_OVERLAP;
+	while (overlap < MAX_OVERLAP && overlap < overlap_arg)
+		overlap <<= 1;
+	return overlap;
+}
+
+static unsigned check_interpolation(const double interpolation_arg)
+{
+	if (interpolation_arg == INTERP_HERMITE)
+		return INTERP_HERMITE;
+	else if (interpolation_arg == INTERP_SINC)
+		return INTERP_SINC;
+	else
+		return INTERP_LINEAR;
+}
+
+static void fill_hann_window(double* const window, const unsigned fft_size)
+{
+	for (size_t i = 0; i < fft_size; i++)
+		window[i] = 0.5 * (1 - cos(2 * M_PI * i / fft_size));
+}
+
+static struct fftw_plan_s* plan_fft(const unsigned fft_size,
+                                    double* const win,
+                                    const fftw_r2r_kind kind,
+                                    const unsigned fallback_flags)
+{
+	struct fftw_plan_s* plan = fftw_plan_r2r_1d(fft_size,
+	                                            win,
+	                                            win,
+	                                            kind,
+	                                            FFTW_PATIENT |
+	                                            FFTW_WISDOM_ONLY);
+	if (plan == NULL)
+		plan = fftw_plan_r2r_1d(fft_size, win, win, kind, fallback_flags);
+	return plan;
+}
+
+static double* take_from_arena(double** const arena,
+                               const unsigned fft_size)
+{
+	double* const win = *arena;
+	*arena += fft_size;
+	return win;
+}
+
+static void alloc_fft_voice(double** const arena,
+                            double** fwin,
+                            double** bwin,
+                            double** pwin,
+                            struct fftw_plan_s** fft_fwin_forw,
+                            struct fftw_plan_s** fft_fwin_back,
+                            struct fftw_plan_s** fft_bwin_forw,
+                            const unsigned fft_size,
+                            const unsigned flags)
+{
+	*fwin          = take_from_arena(arena, fft_size);
+	*bwin          = take_from_arena(arena, fft_size);
+	*pwin          = take_from_arena(arena, fft_size);
+	*fft_fwin_forw = plan_fft(fft_size, *fwin, FFTW_R2HC, flags);
+	*fft_fwin_back = plan_fft(fft_size, *fwin, FFTW_HC2R, flags);
+	*fft_bwin_forw = plan_fft(fft_size, *bwin, FFTW_R2HC, flags);
+}
+
+static void free_fft_voice(struct fftw_plan_s* fft_fwin_forw,
+                           struct fftw_plan_s* fft_fwin_back,
+                           struct fftw_plan_s* fft_bwin_forw)
+{
+	fftw_destroy_plan(fft_fwin_forw);
+	fftw_destroy_plan(fft_fwin_back);
+	fftw_destroy_plan(fft_bwin_forw);
+}
+
+static size_t arena_bytes(const unsigned fft_size)
+{
+	// the window, three per voice and three out frames
+	const size_t wins = 1 + 3 * (1 + MAX_CHORUS_VOICES) + 3;
+	return sizeof(double) * (ARENA_CONSTANTS + wins * fft_size);
+}
+
+// leaves the machinery as it was if there's no memory for the arena
+static bool alloc_fft_buffers(struct warpy_fft_machinery* fft_mach,
+                              const unsigned fft_size,
+                              const unsigned flags)
+{
+	const size_t bytes = arena_bytes(fft_size);
+	double* arena      = aligned_alloc(ARENA_ALIGN, bytes);
+	if (!arena)
+		return false;
+	// zeroed, since a note's first frame vocodes against pwin
+	memset(arena, '\0', bytes);
+
+	pthread_mutex_lock(&planner_lock);
+
+	fft_mach->fft_size = fft_size;
+	fft_mach->arena    = arena;
+
+	fft_mach->max_detune = arena;
+	fft_mach->max_pan    = arena + MAX_CHORUS_VOICES;
+	memcpy(fft_mach->max_detune, max_detunes, sizeof(max_detunes));
+	memcpy(fft_mach->max_pan, max_pans, sizeof(max_pans));
+	arena += ARENA_CONSTANTS;
+
+	fft_mach->window = take_from_arena(&arena, fft_size);
+	fill_hann_window(fft_mach->window, fft_size);
+
+	alloc_fft_voice(&arena,
+	                &fft_mach->fwin,
+	                &fft_mach->bwin,
+	                &fft_mach->pwin,
+	                &fft_mach->fft_fwin_forw,
+	                &fft_mach->fft_fwin_back,
+	                &fft_mach->fft_bwin_forw,
+	                fft_size,
+	                flags);
+
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++) {
+		struct warpy_chorus_voice* voice = &fft_mach->chor_voices[i];
+		alloc_fft_voice(&arena,
+		                &voice->fwin,
+		                &voice->bwin,
+		                &voice->pwin,
+		                &voice->fft_fwin_forw,
+		                &voice->fft_fwin_back,
+		                &voice->fft_bwin_forw,
+		                fft_size,
+		                flags);
+	}
+
+	fft_mach->frames.center = take_from_arena(&arena, fft_size);
+	fft_mach->frames.chor_l = take_from_arena(&arena, fft_size);
+	fft_mach->frames.chor_r = take_from_arena(&arena, fft_size);
+
+	pthread_mutex_unlock(&planner_lock);
+	return true;
+}
+
+static void free_fft_buffers(struct warpy_fft_machinery* fft_mach)
+{
+	pthread_mutex_lock(&planner_lock);
+
+	free_fft_voice(fft_mach->fft_fwin_forw,
+	               fft_mach->fft_fwin_back,
+	               fft_mach->fft_bwin_forw);
+
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++) {
+		struct warpy_chorus_voice* voice = &fft_mach->chor_voices[i];
+		free_fft_voice(voice->fft_fwin_forw,
+		               voice->fft_fwin_back,
+		               voice->fft_bwin_forw);
+	}
+
+	free(fft_mach->arena);
+
+	pthread_mutex_unlock(&planner_lock);
+}
+
+static bool init_warpy_fft(struct warpy_fft_machinery* fft_mach)
+{
+	fft_mach->state = MACH_FREE;
+	return alloc_fft_buffers(fft_mach, DEFAULT_FFT_SIZE, FFTW_PATIENT);
+}
+
+static void resize_warpy_fft(struct warpy_fft_machinery* fft_mach,
+                             const unsigned fft_size)
+{
+	if (fft_mach->fft_size == fft_size)
+		return;
+
+	// patient planning for every machinery would hold the worker up
+	// for too long, so only use patient plans if they're already in the
+	// wisdom and estimate the rest; without the memory for the new
+	// size the machinery keeps the old one
+	struct warpy_fft_machinery old = *fft_mach;
+	if (alloc_fft_buffers(fft_mach, fft_size, FFTW_ESTIMATE))
+		free_fft_buffers(&old);
+}
+
+static size_t chorus_scales_index(const double scale_val_arg)
+{
+	double scale_val;
+	if (scale_val_arg < 0)
+		scale_val = 0;
+	else if (scale_val_arg > 1)
+		scale_val = 1;
+	else
+		scale_val = scale_val_arg;
+
+	size_t scale_index = scale_val * max_chorus_scale_val;
+	return scale_index;
+}
+
+static double get_chorus_detune(const double detune)
+{
+	size_t index = chorus_scales_index(detune);
+	double scaled_detune = chorus_detune_scale[index];
+	return scaled_detune;
+}
+
+static double get_chorus_mix_center(const double mix)
+{
+	size_t index = chorus_scales_index(mix);
+	double scaled_mix = chorus_mix_center_scale[index];
+	return scaled_mix;
+}
+
+static double get_chorus_mix_sides(const double mix)
+{
+	size_t index = chorus_scales_index(mix);
+	double scaled_mix = chorus_mix_side_scale[index];
+	return scaled_mix;
+}
+
+// a note that plays its channel to both sides only ever hears the center,
+// so its chorus voices aren't worth analysing
+static inline size_t heard_chorus_voices(const struct vochorus* const p)
+{
+	if (p->main_channel_pan == BOTH_CHANNELS)
+		return 0;
+	return p->no_of_c_voices < MAX_CHORUS_VOICES ?
+	       p->no_of_c_voices : MAX_CHORUS_VOICES;
+}
+
+static inline void run_forward_ffts(struct vochorus* const p)
+{
+	fftw_execute(p->fft_mach->fft_fwin_forw);
+	fftw_execute(p->fft_mach->fft_bwin_forw);
+
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++) {
+		if (heard_chorus_voices(p) > i) {
+			struct warpy_chorus_voice* voice =
+			        &p->fft_mach->chor_voices[i];
+			fftw_execute(voice->fft_fwin_forw);
+			fftw_execute(voice->fft_bwin_forw);
+		}
+	}
+}
+
+// read positions are 32.32 fixed point so that stepping through a window
+// is an exact integer add rather than an accumulating double
+#define SEEK_FRAC_BITS 32
+
+static const int64_t seek_one        = (int64_t)1 << SEEK_FRAC_BITS;
+static const double  seek_frac_scale = 1.0 / ((int64_t)1 << SEEK_FRAC_BITS);
+
+static inline int64_t to_fixed_seek(const double seek)
+{
+	return llround(seek * seek_one);
+}
+
+static inline int64_t wrap_index(const int64_t index, const int64_t len)
+{
+	const int64_t wrapped = index % len;
+	return wrapped < 0 ? wrapped + len : wrapped;
+}
+
+// windowed sinc tables, one per octave of pitch so that reading faster
+// than the sample rate still gets band-limited; each level doubles the
+// taps as it halves the cutoff
+#define SINC_LEVELS     4
+#define SINC_BASE_TAPS  8
+#define SINC_MAX_TAPS   (SINC_BASE_TAPS << (SINC_LEVELS - 1))
+#define SINC_PHASES     256
+#define SINC_PHASE_BITS 8
+
+static double*        sinc_tables[SINC_LEVELS];
+static pthread_once_t sinc_tables_once = PTHREAD_ONCE_INIT;
+
+static double blackman(const double x)
+{
+	// x runs from -1 to 1 across the window
+	return 0.42 + 0.5 * cos(M_PI * x) + 0.08 * cos(2 * M_PI * x);
+}
+
+static void fill_sinc_table(double* const table,
+                            const unsigned taps,
+                            const double cutoff)
+{
+	// one extra phase so that the last one can be interpolated towards
+	const double half_taps = taps / 2;
+	for (size_t phase = 0; phase <= SINC_PHASES; phase++) {
+		double* const coefs = &table[phase * taps];
+		const double frac = (double)phase / SINC_PHASES;
+		double sum = 0;
+		for (size_t tap = 0; tap < taps; tap++) {
+			const double x = (double)tap - (half_taps - 1) - frac;
+			const double arg = M_PI * cutoff * x;
+			const double sinc = x == 0 ? 1 : sin(arg) / arg;
+			coefs[tap] = sinc * blackman(x / half_taps);
+			sum += coefs[tap];
+		}
+		for (size_t tap = 0; tap < taps; tap++)
+			coefs[tap] /= sum;
+	}
+}
+
+// made once for the process, so a table there wasn't the memory for
+// stays missing and no pool can be created
+static void make_sinc_tables(void)
+{
+	for (size_t level = 0; level < SINC_LEVELS; level++) {
+		const unsigned taps = SINC_BASE_TAPS << level;
+		sinc_tables[level] = malloc(sizeof(double) * taps *
+		                            (SINC_PHASES + 1));
+		if (sinc_tables[level])
+			fill_sinc_table(sinc_tables[level],
+			                taps,
+			                0.9 / (1 << level));
+	}
+}
+
+static bool have_sinc_tables(void)
+{
+	for (size_t level = 0; level < SINC_LEVELS; level++)
+		if (!sinc_tables[level])
+			return false;
+	return true;
+}
+
+static unsigned sinc_level(const int64_t step)
+{
+	const double speed = fabs((double)step * seek_frac_scale);
+	unsigned level = 0;
+	while (level < SINC_LEVELS - 1 && (1 << level) < speed)
+		level++;
+	return level;
+}
+
+struct window_reader {
+	unsigned      interpolation;
+	const double* sinc_table;
+	unsigned      sinc_taps;
+	// how far either side of the read position the interpolation looks
+	int64_t       reach_before;
+	int64_t       reach_after;
+};
+
+static struct window_reader make_window_reader(const unsigned interpolation,
+                                               const int64_t step)
+{
+	struct window_reader reader;
+	reader.interpolation = interpolation;
+	reader.sinc_table = NULL;
+	reader.sinc_taps = 0;
+	if (interpolation == INTERP_HERMITE) {
+		reader.reach_before = 1;
+		reader.reach_after  = 2;
+	}
+	else if (interpolation == INTERP_SINC) {
+		const unsigned level = sinc_level(step);
+		reader.sinc_table    = sinc_tables[level];
+		reader.sinc_taps     = SINC_BASE_TAPS << level;
+		reader.reach_before  = reader.sinc_taps / 2 - 1;
+		reader.reach_after   = reader.sinc_taps / 2;
+	}
+	else {
+		reader.reach_before = 0;
+		reader.reach_after  = 1;
+	}
+	return reader;
+}
+
+static inline int64_t read_pos_of(const int64_t seek)
+{
+	return seek >> SEEK_FRAC_BITS;
+}
+
+static inline double frac_of(const int64_t seek)
+{
+	return (double)(seek & (seek_one - 1)) * seek_frac_scale;
+}
+
+static inline double hermite(const double frac,
+                             const double xm1,
+                             const double x0,
+                             const double x1,
+                             const double x2)
+{
+	const double c1 = 0.5 * (x1 - xm1);
+	const double c2 = xm1 - 2.5 * x0 + 2 * x1 - 0.5 * x2;
+	const double c3 = 0.5 * (x2 - xm1) + 1.5 * (x0 - x1);
+	return ((c3 * frac + c2) * frac + c1) * frac + x0;
+}
+
+static inline double sinc_interpolate(const double* restrict const taps,
+                                      const struct window_reader* reader,
+                                      const int64_t seek)
+{
+	// blend the two nearest phases of the table
+	const int64_t frac = seek & (seek_one - 1);
+	const size_t phase = frac >> (SEEK_FRAC_BITS - SINC_PHASE_BITS);
+	const double phase_frac =
+	        (double)(frac & ((1 << (SEEK_FRAC_BITS - SINC_PHASE_BITS)) - 1)) /
+	        (1 << (SEEK_FRAC_BITS - SINC_PHASE_BITS));
+	const unsigned tap_count = reader->sinc_taps;
+	const double* restrict const coefs =
+	        &reader->sinc_table[phase * tap_count];
+	const double* restrict const next_coefs = &coefs[tap_count];
+
+	double sum = 0;
+	for (size_t tap = 0; tap < tap_count; tap++)
+		sum += taps[tap] * (coefs[tap] + phase_frac *
+		                    (next_coefs[tap] - coefs[tap]));
+	return sum;
+}
+
+static size_t segment_len(const int64_t seek,
+                          const int64_t step,
+                          const int64_t lowest,
+                          const int64_t highest,
+                          const size_t remaining)
+{
+	// how many reads in a row stay in [lowest, highest) without wrapping
+	const int64_t read_pos = read_pos_of(seek);
+	if (read_pos < lowest || read_pos >= highest)
+		return 0;
+
+	int64_t len;
+	if (step > 0)
+		len = ((highest << SEEK_FRAC_BITS) - seek + step - 1) / step;
+	else if (step < 0)
+		len = (seek - (lowest << SEEK_FRAC_BITS)) / -step + 1;
+	else
+		len = remaining;
+
+	return len < (int64_t)remaining ? (size_t)len : remaining;
+}
+
+// nothing in the segment readers wraps, so the compiler is free to
+// vectorize them
+
+static void read_segment_linear(double* restrict const win,
+                                const double* restrict const window,
+                                const double* restrict const sample,
+                                const int64_t seek,
+                                const int64_t step,
+                                const size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		const int64_t pos = seek + (int64_t)i * step;
+		const int64_t read_pos = read_pos_of(pos);
+		const double frac = frac_of(pos);
+		const double this_sample = sample[read_pos];
+		win[i] = (this_sample + frac *
+		         (sample[read_pos + 1] - this_sample)) *
+		         window[i];
+	}
+}
+
+static void read_segment_hermite(double* restrict const win,
+                                 const double* restrict const window,
+                                 const double* restrict const sample,
+                                 const int64_t seek,
+                                 const int64_t step,
+                                 const size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		const int64_t pos = seek + (int64_t)i * step;
+		const int64_t read_pos = read_pos_of(pos);
+		win[i] = hermite(frac_of(pos),
+		                 sample[read_pos - 1],
+		                 sample[read_pos],
+		                 sample[read_pos + 1],
+		                 sample[read_pos + 2]) *
+		         window[i];
+	}
+}
+
+static void read_segment_sinc(double* restrict const win,
+                              const double* restrict const window,
+                              const double* restrict const sample,
+                              const int64_t seek,
+                              const int64_t step,
+                              const size_t len,
+                              const struct window_reader* const reader)
+{
+	for (size_t i = 0; i < len; i++) {
+		const int64_t pos = seek + (int64_t)i * step;
+		const int64_t first_tap = read_pos_of(pos) - reader->reach_before;
+		win[i] = sinc_interpolate(&sample[first_tap], reader, pos) *
+		         window[i];
+	}
+}
+
+static double read_wrapped(const int64_t seek,
+                           const double* const sample,
+                           const int64_t sample_len,
+                           const struct window_reader* const reader)
+{
+	const int64_t read_pos = read_pos_of(seek);
+	const double frac = frac_of(seek);
+	if (reader->interpolation == INTERP_HERMITE) {
+		return hermite(frac,
+		               sample[wrap_index(read_pos - 1, sample_len)],
+		               sample[wrap_index(read_pos,     sample_len)],
+		               sample[wrap_index(read_pos + 1, sample_len)],
+		               sample[wrap_index(read_pos + 2, sample_len)]);
+	}
+	else if (reader->interpolation == INTERP_SINC) {
+		double taps[SINC_MAX_TAPS];
+		const int64_t first_tap = read_pos - reader->reach_before;
+		for (size_t tap = 0; tap < reader->sinc_taps; tap++)
+			taps[tap] = sample[wrap_index(first_tap + tap, sample_len)];
+		return sinc_interpolate(taps, reader, seek);
+	}
+	else {
+		const double this_sample =
+		        sample[wrap_index(read_pos, sample_len)];
+		const double next_sample =
+		        sample[wrap_index(read_pos + 1, sample_len)];
+		return this_sample + frac * (next_sample - this_sample);
+	}
+}
+
+static void read_window(double* const win,
+                        int64_t seek,
+                        const int64_t step,
+                        const struct vochorus* const p)
+{
+	const unsigned fft_size = p->fft_size;
+	const double* const window = p->fft_mach->window;
+	const double* const sample = p->sample;
+	const int64_t sample_len = p->sample_len;
+	const int64_t fixed_sample_len = sample_len << SEEK_FRAC_BITS;
+	const struct window_reader reader = make_window_reader(p->interpolation,
+	                                                       step);
+	const int64_t lowest = reader.reach_before;
+	const int64_t highest = sample_len - reader.reach_after;
+
+	size_t i = 0;
+	while (i < fft_size) {
+		seek = wrap_index(seek, fixed_sample_len);
+		const size_t len = segment_len(seek,
+		                               step,
+		                               lowest,
+		                               highest,
+		                               fft_size - i);
+		if (len > 0) {
+			if (reader.interpolation == INTERP_HERMITE)
+				read_segment_hermite(&win[i], &window[i], sample,
+				                     seek, step, len);
+			else if (reader.interpolation == INTERP_SINC)
+				read_segment_sinc(&win[i], &window[i], sample,
+				                  seek, step, len, &reader);
+			else
+				read_segment_linear(&win[i], &window[i], sample,
+				                    seek, step, len);
+			i += len;
+			seek += (int64_t)len * step;
+		}
+		else {
+			// some of the interpolation is across the loop point
+			win[i] = read_wrapped(seek, sample, sample_len, &reader) *
+			         window[i];
+			i++;
+			seek += step;
+		}
+	}
+}
+
+static void fill_win_bins(double* fwin,
+                          double* bwin,
+                          const double sample_seek,
+                          const double pitch,
+                          const struct vochorus* const p)
+{
+	const int64_t seek = to_fixed_seek(sample_seek);
+	const int64_t step = to_fixed_seek(pitch);
+	read_window(fwin, seek, step, p);
+	read_window(bwin, seek - (int64_t)p->hop_size * step, step, p);
+}
+
+static int64_t grain_start(const struct vochorus* const p,
+                           const double seek_point)
+{
+	const double seek_time = seek_point * p->rate_adjust;
+	const unsigned hop_size = p->hop_size;
+	const int64_t sample_seek_in_hops =
+	        (int64_t)(seek_time * p->env_samp_rate / hop_size);
+	return hop_size * sample_seek_in_hops;
+}
+
+// the first onset at or after first and before first + len, with the read
+// wrapped into the sample like read_window does, or -1
+static int64_t find_onset(const struct vochorus* const p,
+                          const int64_t from,
+                          const int64_t len)
+{
+	const int64_t sample_len = p->sample_len;
+	const int64_t first = wrap_index(from, sample_len);
+	const int64_t last = first + len;
+	const size_t* const onsets = p->onsets;
+	size_t low = 0;
+	size_t high = p->onset_cnt;
+	while (low < high) {
+		const size_t mid = (low + high) / 2;
+		if ((int64_t)onsets[mid] < first)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low < p->onset_cnt && (int64_t)onsets[low] < last)
+		return onsets[low];
+	// past the loop point the read carries on from the start
+	if (last > sample_len && (int64_t)onsets[0] < last - sample_len)
+		return onsets[0];
+	return -1;
+}
+
+// whether an onset has just come into the grain's read, which is the
+// newest hop of it unless the read jumped further than that since the
+// last grain; each onset only resets the phases once on its way through
+static bool onset_enters_grain(struct vochorus* const p,
+                               const int64_t start,
+                               const double pitch)
+{
+	if (p->onset_cnt == 0)
+		return false;
+	const int64_t read_len = (int64_t)ceil(p->fft_size * pitch);
+	const int64_t advance = start - p->last_grain;
+	const bool moving_on = p->has_last_grain &&
+	                       advance >= 0 && advance < read_len;
+
+	int64_t span = (int64_t)ceil(p->hop_size * pitch);
+	if (!p->has_last_grain)
+		span = read_len;
+	else if (moving_on && advance > span)
+		span = advance;
+	if (span > (int64_t)p->sample_len)
+		span = p->sample_len;
+
+	const int64_t onset = find_onset(p, start + read_len - span, span);
+	if (onset < 0 || (moving_on && onset == p->last_onset))
+		return false;
+	p->last_onset = onset;
+	return true;
+}
+
+static double chorus_voice_pitch(const struct vochorus* const p,
+                                 const size_t voice)
+{
+	const double max_detune = p->fft_mach->max_detune[voice];
+	return max_detune * get_chorus_detune(p->detune) + p->pitch;
+}
+
+static void fill_bins(struct vochorus* const p, const double sample_seek)
+{
+	fill_win_bins(p->fft_mach->fwin,
+	              p->fft_mach->bwin,
+		      sample_seek,
+		      p->pitch,
+		      p);
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++) {
+		if (heard_chorus_voices(p) > i) {
+			struct warpy_chorus_voice* voice =
+				&p->fft_mach->chor_voices[i];
+			fill_win_bins(voice->fwin,
+			              voice->bwin,
+			              sample_seek,
+			              chorus_voice_pitch(p, i),
+			              p);
+
+		}
+	}
+}
+
+static inline double atan2_approx(double y, double x)
+{
+	//http://pubs.opengroup.org/onlinepubs/009695399/functions/atan2.html
+	//Volkan SALMA
+	//https://gist.github.com/volkansalma/2972237
+
+	double r, angle;
+	double abs_y = fabs(y) + 1e-10f;      // kludge to prevent 0/0 condition
+	if ( x < 0.0f )
+	{
+		r = (x + abs_y) / (abs_y - x);
+		angle = threeqtr_pi;
+	}
+	else
+	{
+		r = (x - abs_y) / (x + abs_y);
+		angle = M_PI_4;
+	}
+	angle += (0.1963f * r * r - 0.9817f) * r;
+	if ( y < 0.0f )
+		return( -angle );     // negate if in quad III or IV
+	else
+		return( angle );
+}
+
+static void smoothe_phase(const double* const pwin_fft,
+                          double* const bwin,
+                          const unsigned fft_size)
+{
+	const unsigned half_fft_size = fft_size / 2;
+	for (size_t i = 0; i <= half_fft_size; i++) {
+		const bool at_edges = i == 0 || i == half_fft_size;
+		const size_t imag_index = fft_size - i;
+		double pwin_fft_comp[2];
+		pwin_fft_comp[0] = pwin_fft[i];
+		// DC has no imaginary part, and its imag_index is one past the
+		// end, in the next voice's buffers
+		if (i == half_fft_size)
+			pwin_fft_comp[1] = pwin_fft[imag_index];
+		else
+			pwin_fft_comp[1] = 0;
+
+		if (pwin_fft_comp[0] == 0 && pwin_fft_comp[1] == 0)
+			continue;
+
+		const double pwin_pangle = atan2_approx(pwin_fft_comp[0],
+		                                        pwin_fft_comp[1]);
+		const double pwin_angle_sin = sin(pwin_pangle);
+		const double pwin_angle_cos = cos(pwin_pangle);
+
+		bwin[i] = bwin[i] * pwin_angle_sin +
+		          bwin[i] * pwin_angle_cos;
+		if (!at_edges)
+			bwin[imag_index] = bwin[imag_index] * pwin_angle_sin +
+			                   bwin[imag_index] * pwin_angle_cos;
+
+	}
+}
+
+static void vocode_voice(double* const fwin,
+                         double* const bwin,
+                         double* const pwin,
+                         const unsigned fft_size)
+{
+	const unsigned half_fft_size = fft_size / 2;
+	smoothe_phase(pwin, bwin, fft_size);
+	for (size_t i = 0; i <= half_fft_size; i++) {
+		const size_t imag_index = fft_size - i;
+		double plocked_bcomp[] = {0,0};
+		if (i == 0) {
+			plocked_bcomp[0] = bwin[i] +
+			                   bwin[i + 1];
+		}
+		else if (i == half_fft_size) {
+			plocked_bcomp[0] = bwin[i] +
+			                   bwin[i - 1];
+		}
+		else {
+			plocked_bcomp[0] = bwin[i] +
+			                   bwin[i + 1] +
+			                   bwin[i - 1];
+			plocked_bcomp[1] = bwin[imag_index] +
+			                   bwin[imag_index + 1] +
+			                   bwin[imag_index - 1];
+		}
+		const bool at_edges = i == 0 || i == half_fft_size;
+		const double bwin_phase_ang = atan2_approx(plocked_bcomp[0],
+		                                           plocked_bcomp[1]);
+		const double bwin_phase_ang_sin = sin(bwin_phase_ang);
+		const double bwin_phase_ang_cos = cos(bwin_phase_ang);
+		fwin[i] = bwin_phase_ang_sin * fwin[i] +
+			      bwin_phase_ang_cos * fwin[i];
+		pwin[i] = fwin[i];
+		if (!at_edges) {
+			fwin[imag_index] = bwin_phase_ang_sin *
+			                fwin[imag_index] +
+			                bwin_phase_ang_cos *
+			                fwin[imag_index];
+			pwin[imag_index] = fwin[imag_index];
+		}
+	}
+}
+
+// the envelope frame nearest the middle of the grain, which the chorus
+// voices share with the main one
+static const double* grain_envelope(const struct vochorus* const p,
+                                    const int64_t start)
+{
+	const int64_t read_len = (int64_t)(p->fft_size * p->pitch);
+	const int64_t middle = wrap_index(start + read_len / 2, p->sample_len);
+	int64_t frame = (middle - ENVELOPE_FFT_SIZE / 2 + ENVELOPE_HOP / 2) /
+	                ENVELOPE_HOP;
+	if (frame < 0)
+		frame = 0;
+	if (frame >= (int64_t)p->envelope_cnt)
+		frame = p->envelope_cnt - 1;
+	return &p->envelopes[frame * VOCHORUS_ENVELOPE_BINS];
+}
+
+static inline double envelope_at(const double* const envelope,
+                                 const double bin)
+{
+	if (bin >= VOCHORUS_ENVELOPE_BINS - 1)
+		return envelope[VOCHORUS_ENVELOPE_BINS - 1];
+	const size_t index = (size_t)bin;
+	const double frac = bin - index;
+	return envelope[index] + frac * (envelope[index + 1] - envelope[index]);
+}
+
+// reading faster moves the formants up along with everything else, so
+// each bin is scaled by the envelope the sample has where the bin is
+// heard over the one it has where the bin was read from; the grain's
+// energy is kept, since this should move its color and not its level
+static void restore_voice_formants(double* const fwin,
+                                   const double* const envelope,
+                                   const double pitch,
+                                   const struct vochorus* const p)
+{
+	if (pitch <= 0)
+		return;
+	const unsigned fft_size = p->fft_size;
+	const unsigned half_fft_size = fft_size / 2;
+	const double bins_per_grain_bin =
+	        (double)(VOCHORUS_ENVELOPE_BINS - 1) / half_fft_size;
+	const double heard_scale = bins_per_grain_bin / p->rate_adjust;
+	const double read_scale = bins_per_grain_bin / pitch;
+	const double max_log_gain = log(ENVELOPE_MAX_GAIN);
+	double energy_before = 0;
+	double energy_after = 0;
+	for (size_t i = 0; i <= half_fft_size; i++) {
+		double log_gain = envelope_at(envelope, i * heard_scale) -
+		                  envelope_at(envelope, i * read_scale);
+		if (log_gain > max_log_gain)
+			log_gain = max_log_gain;
+		else if (log_gain < -max_log_gain)
+			log_gain = -max_log_gain;
+		const double gain = exp(log_gain);
+		double energy = fwin[i] * fwin[i];
+		fwin[i] *= gain;
+		if (i > 0 && i < half_fft_size) {
+			const size_t imag_index = fft_size - i;
+			energy += fwin[imag_index] * fwin[imag_index];
+			fwin[imag_index] *= gain;
+		}
+		energy_before += energy;
+		energy_after += energy * gain * gain;
+	}
+	if (energy_after == 0)
+		return;
+	const double level = sqrt(energy_before / energy_after);
+	for (size_t i = 0; i < fft_size; i++)
+		fwin[i] *= level;
+}
+
+static void restore_formants(struct vochorus* p, const int64_t start)
+{
+	if (p->envelopes == NULL || p->envelope_cnt == 0)
+		return;
+	const double* const envelope = grain_envelope(p, start);
+	restore_voice_formants(p->fft_mach->fwin, envelope, p->pitch, p);
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++) {
+		if (heard_chorus_voices(p) > i) {
+			struct warpy_chorus_voice* voice =
+			        &p->fft_mach->chor_voices[i];
+			restore_voice_formants(voice->fwin,
+			                       envelope,
+			                       chorus_voice_pitch(p, i),
+			                       p);
+		}
+	}
+}
+
+// a grain over a transient keeps the phases it was read with, rather
+// than having them smoothed into the last frame's, so the attack is
+// neither smeared nor echoed ahead of itself; the frames after carry on
+// from these phases
+static void reset_phases(struct vochorus* p)
+{
+	const size_t bytes = sizeof(double) * p->fft_size;
+	memcpy(p->fft_mach->pwin, p->fft_mach->fwin, bytes);
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++) {
+		if (heard_chorus_voices(p) > i) {
+			struct warpy_chorus_voice* voice =
+			        &p->fft_mach->chor_voices[i];
+			memcpy(voice->pwin, voice->fwin, bytes);
+		}
+	}
+}
+
+static void vocode(struct vochorus* p)
+{
+	vocode_voice(p->fft_mach->fwin,
+	             p->fft_mach->bwin,
+	             p->fft_mach->pwin,
+	             p->fft_size);
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++)
+	{
+		if (heard_chorus_voices(p) > i) {
+			struct warpy_chorus_voice* voice =
+			        &p->fft_mach->chor_voices[i];
+			vocode_voice(voice->fwin,
+			             voice->bwin,
+			             voice->pwin,
+			             p->fft_size);
+		}
+	}
+}
+
+static inline void run_backwards_fft(double* const win,
+                                     struct fftw_plan_s* const plan,
+                                     const unsigned fft_size)
+{
+	fftw_execute(plan);
+	// FFTW backwards FFT output is scaled up by N
+	for (size_t i = 0; i < fft_size; i++)
+		win[i] /= fft_size;
+}
+
+static void run_backwards_ffts(struct vochorus* p)
+{
+	run_backwards_fft(p->fft_mach->fwin,
+	                  p->fft_mach->fft_fwin_back,
+	                  p->fft_size);
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++) {
+		if (heard_chorus_voices(p) > i) {
+			struct warpy_chorus_voice* voice =
+			        &p->fft_mach->chor_voices[i];
+			run_backwards_fft(voice->fwin,
+			                  voice->fft_fwin_back,
+			                  p->fft_size);
+		}
+	}
+}
+
+// adds what is left of a windowed frame to an overlap-add ring, from the
+// sample playing next on
+static void add_to_ring(double* const ring,
+                        const size_t pos,
+                        const double* const frame,
+                        const double* const window,
+                        const double gain,
+                        const size_t already_played,
+                        const size_t fft_size)
+{
+	const size_t len = fft_size - already_played;
+	const size_t to_end = fft_size - pos;
+	const size_t first = to_end < len ? to_end : len;
+	const double* const frame_left = frame + already_played;
+	const double* const window_left = window + already_played;
+	for (size_t i = 0; i < first; i++)
+		ring[pos + i] += frame_left[i] * window_left[i] * gain;
+	for (size_t i = first; i < len; i++)
+		ring[i - first] += frame_left[i] * window_left[i] * gain;
+}
+
+// a frame is windowed as it's read and again as it's added, and Hann
+// squared overlapping every hop sums to 3 * overlap / 8, so this keeps
+// the level from moving with the overlap
+static double synthesis_gain(const unsigned overlap)
+{
+	return 8.0 / (3 * overlap);
+}
+
+static void write_to_out_frames(struct vochorus* const p,
+                                const size_t already_played)
+{
+	const unsigned fft_size = p->fft_size;
+	const size_t pos = p->out_frames_pos;
+	const double* const window = p->fft_mach->window;
+	const double gain = synthesis_gain(p->overlap);
+	add_to_ring(p->frames.center,
+	            pos,
+	            p->fft_mach->fwin,
+	            window,
+	            gain,
+	            already_played,
+	            fft_size);
+
+	// detuned, the voices are close to uncorrelated, so their power adds
+	// and the sides stay at the level of a single voice
+	const size_t voice_cnt = heard_chorus_voices(p);
+	if (voice_cnt == 0)
+		return;
+	const double side_gain = gain / sqrt((double)voice_cnt);
+	const double spread = p->spread;
+	for (size_t i = 0; i < voice_cnt; i++) {
+		const struct warpy_chorus_voice* const voice =
+		        &p->fft_mach->chor_voices[i];
+		if (p->output_cnt == 1) {
+			add_to_ring(p->frames.chor_l,
+			            pos,
+			            voice->fwin,
+			            window,
+			            side_gain,
+			            already_played,
+			            fft_size);
+			continue;
+		}
+
+		const double max_pan = p->fft_mach->max_pan[i];
+		const double pan = (spread * (max_pan - 0.5) + 0.5) * M_PI_2;
+		add_to_ring(p->frames.chor_l,
+		            pos,
+		            voice->fwin,
+		            window,
+		            cos(pan) * side_gain,
+		            already_played,
+		            fft_size);
+		add_to_ring(p->frames.chor_r,
+		            pos,
+		            voice->fwin,
+		            window,
+		            sin(pan) * side_gain,
+		            already_played,
+		            fft_size);
+	}
+}
+
+static void write_to_output(struct vochorus* const p,
+                            double* const* const out,
+                            const size_t n)
+{
+	const uint32_t output_arg_cnt = p->output_cnt;
+	const double mix_arg = p->mix;
+	const double center_mix = get_chorus_mix_center(mix_arg);
+	const double sides_mix = get_chorus_mix_sides(mix_arg);
+	const size_t pos = p->out_frames_pos;
+
+	double center = p->frames.center[pos];
+	if (p->no_of_c_voices > 0 && p->mix > 0)
+		center *= center_mix;
+	for (size_t channel = 0; channel < output_arg_cnt; channel++) {
+		double sample;
+		if (p->main_channel_pan == BOTH_CHANNELS)
+			sample = center;
+		else if (channel == 0) {
+			sample = p->frames.chor_l[pos] * sides_mix / 2;
+			if (p->main_channel_pan == LEFT_ONLY)
+				sample += center;
+		}
+		else {
+			sample = p->frames.chor_r[pos] * sides_mix / 2;
+			if (p->main_channel_pan == RIGHT_ONLY)
+				sample += center;
+		}
+		// what the overlap-add used to come to at the default
+		// overlap, times the 0.3 it was scaled by
+		const double amp_scaling = 0.9;
+		out[channel][n] = sample * amp_scaling;
+	}
+
+	// cleared for the frame that reaches this far next
+	p->frames.center[pos] = 0;
+	p->frames.chor_l[pos] = 0;
+	p->frames.chor_r[pos] = 0;
+	p->out_frames_pos = pos + 1 == p->fft_size ? 0 : pos + 1;
+}
+
+// without chorus voices or a pitch shift there's nothing for the FFTs to
+// do, and the grains can go straight from the sample to the out frames
+static bool plays_straight(const struct vochorus* const p)
+{
+	return p->no_of_c_voices == 0 &&
+	       fabs(p->pitch - 1) < UNITY_PITCH_TOLERANCE;
+}
+
+static double correlate_grains(const struct vochorus* const p,
+                               const int64_t natural,
+                               const int64_t candidate,
+                               const size_t span)
+{
+	const double* const sample = p->sample;
+	const int64_t sample_len = p->sample_len;
+	double sum = 0;
+	for (size_t i = 0; i < span; i += WSOLA_STRIDE)
+		sum += sample[wrap_index(natural + i, sample_len)] *
+		       sample[wrap_index(candidate + i, sample_len)];
+	return sum;
+}
+
+// WSOLA: when the stretch moves the read position off where the last
+// grain would have carried on, look nearby for where the sample lines up
+// with that best, so the overlap adds up rather than cancelling; at
+// speed 1 the two never part and every grain is a straight copy
+static int64_t align_grain(const struct vochorus* const p,
+                           const int64_t target)
+{
+	if (!p->has_last_grain)
+		return target;
+	const int64_t natural = p->last_grain + p->hop_size;
+	if (target == natural)
+		return target;
+
+	const unsigned half_hop = p->hop_size / 2;
+	const int64_t reach = half_hop < WSOLA_MAX_REACH ? half_hop :
+	                                                   WSOLA_MAX_REACH;
+	const size_t span = p->hop_size < WSOLA_MAX_SPAN ? p->hop_size :
+	                                                   WSOLA_MAX_SPAN;
+	int64_t best = target;
+	double best_score = -INFINITY;
+	for (int64_t offset = -reach; offset <= reach; offset += 2) {
+		const double score = correlate_grains(p,
+		                                      natural,
+		                                      target + offset,
+		                                      span);
+		if (score > best_score) {
+			best_score = score;
+			best = target + offset;
+		}
+	}
+	return best;
+}
+
+// the phase smoothing starts over after a stretch in the time domain,
+// the same as it does at the start of a note
+static void forget_phases(struct vochorus* const p)
+{
+	const size_t bytes = sizeof(double) * p->fft_size;
+	memset(p->fft_mach->pwin, '\0', bytes);
+	for (size_t i = 0; i < MAX_CHORUS_VOICES; i++)
+		memset(p->fft_mach->chor_voices[i].pwin, '\0', bytes);
+}
+
+// both ways end with a grain in fwin that has been through the window
+// once, so switching between them crossfades over the overlap-add like
+// any other pair of frames
+static void run_frame(struct vochorus* const p,
+                      const double seek_point,
+                      const size_t already_played)
+{
+	const int64_t start = grain_start(p, seek_point);
+	const bool straight = plays_straight(p);
+	if (straight) {
+		p->last_grain = align_grain(p, start);
+		read_window(p->fft_mach->fwin,
+		            p->last_grain * seek_one,
+		            seek_one,
+		            p);
+	}
+	else {
+		if (p->time_domain)
+			forget_phases(p);
+		const bool onset = onset_enters_grain(p, start, p->pitch);
+		p->last_grain = start;
+		fill_bins(p, start);
+		run_forward_ffts(p);
+		restore_formants(p, start);
+		if (onset)
+			reset_phases(p);
+		else
+			vocode(p);
+		run_backwards_ffts(p);
+	}
+	p->time_domain = straight;
+	p->has_last_grain = true;
+	write_to_out_frames(p, already_played);
+	p->up_to_hop_size = 0;
+}
+
+static void preroll(struct vochorus* const p, const double seek_point)
+{
+	// without this the first overlap-add window fades in over N samples,
+	// so pretend the note has been playing for N samples already, with
+	// the earlier frames partly played out
+	const double hop_time = p->hop_size /
+	                        (p->env_samp_rate * p->rate_adjust);
+	for (size_t hop = p->overlap - 1; hop > 0; hop--)
+		run_frame(p, seek_point - hop * hop_time, hop * p->hop_size);
+}
+
+struct vochorus_pool {
+	struct warpy_fft_machinery machs[MAX_POLY];
+	size_t dropped;
+};
+
+struct vochorus_pool* create_vochorus_pool(void)
+{
+	pthread_once(&sinc_tables_once, make_sinc_tables);
+	if (!have_sinc_tables())
+		return NULL;
+
+	struct vochorus_pool* pool =
+	        (struct vochorus_pool*)malloc(sizeof(struct vochorus_pool));
+	if (!pool)
+		return NULL;
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		if (!init_warpy_fft(&pool->machs[i])) {
+			for (size_t j = 0; j < i; j++)
+				free_fft_buffers(&pool->machs[j]);
+			free(pool);
+			return NULL;
+		}
+	}
+	pool->dropped = 0;
+	return pool;
+}
+
+void destroy_vochorus_pool(struct vochorus_pool* pool)
+{
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct warpy_fft_machinery* fft_mach = &pool->machs[i];
+		free_fft_buffers(fft_mach);
+	}
+	free(pool);
+}
+
+size_t take_vochorus_dropped(struct vochorus_pool* pool)
+{
+	return __atomic_exchange_n(&pool->dropped, 0, __ATOMIC_RELAXED);
+}
+
+// fopen doesn't expand $HOME, so the wisdom was never found before
+static bool wisdom_path(char* const path, const size_t size, const bool dir)
+{
+	const char* const home = getenv("HOME");
+	if (!home || !*home)
+		return false;
+	const int len = snprintf(path, size, "%s%s%s",
+	                         home, WISDOM_DIR, dir ? "" : WISDOM_FILE);
+	return len > 0 && (size_t)len < size;
+}
+
+static pthread_once_t wisdom_once = PTHREAD_ONCE_INIT;
+
+static void import_wisdom_once(void)
+{
+	char path[PATH_MAX];
+	if (!wisdom_path(path, sizeof(path), false))
+		return;
+	pthread_mutex_lock(&planner_lock);
+	fftw_import_wisdom_from_filename(path);
+	pthread_mutex_unlock(&planner_lock);
+}
+
+// every instance used to read the file again, once a process is enough
+// since the planner keeps its wisdom until the process exits
+void import_vochorus_wisdom(void)
+{
+	pthread_once(&wisdom_once, import_wisdom_once);
+}
+
+void export_vochorus_wisdom(void)
+{
+	char path[PATH_MAX];
+	if (!wisdom_path(path, sizeof(path), true))
+		return;
+	mkdir(path, 0755);
+	if (!wisdom_path(path, sizeof(path), false))
+		return;
+	pthread_mutex_lock(&planner_lock);
+	fftw_export_wisdom_to_filename(path);
+	pthread_mutex_unlock(&planner_lock);
+}
+
+static bool pick_onsets(double* const flux,
+                        const size_t frame_cnt,
+                        const double sample_rate,
+                        size_t** const onsets_out,
+                        size_t* const onset_cnt)
+{
+	const size_t min_gap = (size_t)(ONSET_MIN_GAP_SECS * sample_rate);
+	size_t* onsets = NULL;
+	size_t capacity = 0;
+	for (size_t i = 0; i < frame_cnt; i++) {
+		const size_t mean_start = i > ONSET_MEAN_FRAMES ?
+		                          i - ONSET_MEAN_FRAMES : 0;
+		const size_t mean_end = i + ONSET_MEAN_FRAMES < frame_cnt ?
+		                        i + ONSET_MEAN_FRAMES + 1 : frame_cnt;
+		double mean = 0;
+		bool is_peak = true;
+		for (size_t j = mean_start; j < mean_end; j++) {
+			mean += flux[j];
+			const size_t dist = j > i ? j - i : i - j;
+			if (dist <= ONSET_PEAK_FRAMES && flux[j] > flux[i])
+				is_peak = false;
+		}
+		mean /= mean_end - mean_start;
+		if (!is_peak || flux[i] < mean + ONSET_DELTA)
+			continue;
+
+		// the flux peaks once the attack reaches the middle of the
+		// window
+		const size_t pos = i * ONSET_HOP + ONSET_FFT_SIZE / 2;
+		if (*onset_cnt > 0 && pos - onsets[*onset_cnt - 1] < min_gap)
+			continue;
+		if (*onset_cnt == capacity) {
+			capacity = capacity ? capacity * 2 : 16;
+			size_t* const grown =
+			        (size_t*)realloc(onsets,
+			                         sizeof(size_t) * capacity);
+			if (!grown) {
+				free(onsets);
+				*onset_cnt = 0;
+				return false;
+			}
+			onsets = grown;
+		}
+		onsets[(*onset_cnt)++] = pos;
+	}
+	*onsets_out = onsets;
+	return true;
+}
+
+bool detect_vochorus_onsets(const double* left,
+                            const double* right,
+                            const size_t len,
+                            const double sample_rate,
+                            size_t** onsets,
+                            size_t* onset_cnt)
+{
+	*onsets = NULL;
+	*onset_cnt = 0;
+	if (len < ONSET_FFT_SIZE)
+		return true;
+
+	const size_t half = ONSET_FFT_SIZE / 2;
+	const size_t frame_cnt = (len - ONSET_FFT_SIZE) / ONSET_HOP + 1;
+	double* const flux = (double*)calloc(frame_cnt, sizeof(double));
+	double* const last = (double*)calloc(half + 1, sizeof(double));
+	double* const window = (double*)malloc(sizeof(double) *
+	                                       ONSET_FFT_SIZE);
+	double* const bins = fftw_malloc(sizeof(double) * ONSET_FFT_SIZE);
+	if (!flux || !last || !window || !bins) {
+		free(flux);
+		free(last);
+		free(window);
+		fftw_free(bins);
+		return false;
+	}
+	fill_hann_window(window, ONSET_FFT_SIZE);
+	pthread_mutex_lock(&planner_lock);
+	struct fftw_plan_s* const plan = fftw_plan_r2r_1d(ONSET_FFT_SIZE,
+	                                                  bins,
+	                                                  bins,
+	                                                  FFTW_R2HC,
+	                                                  FFTW_ESTIMATE);
+	pthread_mutex_unlock(&planner_lock);
+
+	for (size_t frame = 0; frame < frame_cnt; frame++) {
+		const double* const l = &left[frame * ONSET_HOP];
+		const double* const r = &right[frame * ONSET_HOP];
+		for (size_t i = 0; i < ONSET_FFT_SIZE; i++)
+			bins[i] = (l[i] + r[i]) * 0.5 * window[i];
+		fftw_execute(plan);
+
+		// rises in log magnitude only, so a note dying away under a
+		// hit doesn't cancel it out
+		double sum = 0;
+		for (size_t k = 0; k <= half; k++) {
+			const double mag = k == 0 || k == half ?
+			                   fabs(bins[k]) :
+			                   hypot(bins[k], bins[ONSET_FFT_SIZE - k]);
+			const double level = log1p(mag);
+			if (level > last[k])
+				sum += level - last[k];
+			last[k] = level;
+		}
+		// the first frame only rises from silence, and a note starts
+		// its phases afresh there anyway
+		flux[frame] = frame > 0 ? sum / (half + 1) : 0;
+	}
+
+	pthread_mutex_lock(&planner_lock);
+	fftw_destroy_plan(plan);
+	pthread_mutex_unlock(&planner_lock);
+	fftw_free(bins);
+	free(window);
+	free(last);
+
+	const bool picked = pick_onsets(flux,
+	                                frame_cnt,
+	                                sample_rate,
+	                                onsets,
+	                                onset_cnt);
+	free(flux);
+	return picked;
+}
+
+bool analyse_vochorus_envelopes(const double* left,
+                                const double* right,
+                                const size_t len,
+                                double** envelopes_out,
+                                size_t* envelope_cnt)
+{
+	*envelopes_out = NULL;
+	*envelope_cnt = 0;
+	if (len < ENVELOPE_FFT_SIZE)
+		return true;
+
+	const size_t half = ENVELOPE_FFT_SIZE / 2;
+	const size_t frame_cnt = (len - ENVELOPE_FFT_SIZE) / ENVELOPE_HOP + 1;
+	double* const envelopes = (double*)malloc(sizeof(double) * frame_cnt *
+	                                          VOCHORUS_ENVELOPE_BINS);
+	double* const window = (double*)malloc(sizeof(double) *
+	                                       ENVELOPE_FFT_SIZE);
+	double* const bins = fftw_malloc(sizeof(double) * ENVELOPE_FFT_SIZE);
+	if (!envelopes || !window || !bins) {
+		free(envelopes);
+		free(window);
+		fftw_free(bins);
+		return false;
+	}
+	fill_hann_window(window, ENVELOPE_FFT_SIZE);
+	pthread_mutex_lock(&planner_lock);
+	struct fftw_plan_s* const forward = fftw_plan_r2r_1d(ENVELOPE_FFT_SIZE,
+	                                                     bins,
+	                                                     bins,
+	                                                     FFTW_R2HC,
+	                                                     FFTW_ESTIMATE);
+	struct fftw_plan_s* const back = fftw_plan_r2r_1d(ENVELOPE_FFT_SIZE,
+	                                                  bins,
+	                                                  bins,
+	                                                  FFTW_HC2R,
+	                                                  FFTW_ESTIMATE);
+	pthread_mutex_unlock(&planner_lock);
+
+	for (size_t frame = 0; frame < frame_cnt; frame++) {
+		const double* const l = &left[frame * ENVELOPE_HOP];
+		const double* const r = &right[frame * ENVELOPE_HOP];
+		for (size_t i = 0; i < ENVELOPE_FFT_SIZE; i++)
+			bins[i] = (l[i] + r[i]) * 0.5 * window[i];
+		fftw_execute(forward);
+
+		// the log magnitudes as a spectrum with no imaginary part, so
+		// that going back gives the real cepstrum
+		for (size_t k = 0; k <= half; k++) {
+			const double mag = k == 0 || k == half ?
+			                   fabs(bins[k]) :
+			                   hypot(bins[k], bins[ENVELOPE_FFT_SIZE - k]);
+			bins[k] = log(mag + ENVELOPE_FLOOR);
+		}
+		for (size_t k = half + 1; k < ENVELOPE_FFT_SIZE; k++)
+			bins[k] = 0;
+		fftw_execute(back);
+
+		for (size_t n = ENVELOPE_CEPSTRA;
+		     n <= ENVELOPE_FFT_SIZE - ENVELOPE_CEPSTRA;
+		     n++)
+			bins[n] = 0;
+		fftw_execute(forward);
+
+		// FFTW leaves the round trip scaled up by N
+		double* const envelope = &envelopes[frame *
+		                                    VOCHORUS_ENVELOPE_BINS];
+		for (size_t b = 0; b < VOCHORUS_ENVELOPE_BINS; b++)
+			envelope[b] = bins[b * ENVELOPE_STRIDE] /
+			              ENVELOPE_FFT_SIZE;
+	}
+
+	pthread_mutex_lock(&planner_lock);
+	fftw_destroy_plan(forward);
+	fftw_destroy_plan(back);
+	pthread_mutex_unlock(&planner_lock);
+	fftw_free(bins);
+	free(window);
+
+	*envelopes_out = envelopes;
+	*envelope_cnt = frame_cnt;
+	return true;
+}
+
+void set_vochorus_size(struct vochorus* p,
+                       const double fft_size_arg,
+                       const double overlap_arg)
+{
+	const unsigned fft_size = check_vochorus_fft_size(fft_size_arg);
+	const unsigned overlap = check_vochorus_overlap(overlap_arg);
+	p->fft_size = fft_size;
+	p->overlap = overlap;
+	p->hop_size = fft_size / overlap;
+}
+
+static void init_out_frames(struct vochorus* p)
+{
+	// don't let the last note's frames ring into this one
+	const size_t out_frames_size = sizeof(double) * p->fft_size;
+	memset(p->frames.center, '\0', out_frames_size);
+	memset(p->frames.chor_l, '\0', out_frames_size);
+	memset(p->frames.chor_r, '\0', out_frames_size);
+}
+
+static bool claim_fft_machinery(struct warpy_fft_machinery* fft_mach,
+                                const int state)
+{
+	int expected = MACH_FREE;
+	return __atomic_compare_exchange_n(&fft_mach->state,
+	                                   &expected,
+	                                   state,
+	                                   false,
+	                                   __ATOMIC_ACQUIRE,
+	                                   __ATOMIC_RELAXED);
+}
+
+static struct warpy_fft_machinery*
+acquire_fft_machinery(struct vochorus_pool* const pool,
+                      const unsigned fft_size)
+{
+	// replanning is for size_vochorus_pool, so until it has caught up
+	// with a new size a note plays on whatever machinery is free
+	struct warpy_fft_machinery* other_size = NULL;
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct warpy_fft_machinery* fft_mach = &pool->machs[i];
+		if (__atomic_load_n(&fft_mach->state, __ATOMIC_ACQUIRE) !=
+		    MACH_FREE)
+			continue;
+		if (fft_mach->fft_size != fft_size) {
+			if (other_size == NULL)
+				other_size = fft_mach;
+			continue;
+		}
+		if (claim_fft_machinery(fft_mach, MACH_IN_USE))
+			return fft_mach;
+	}
+
+	if (other_size != NULL &&
+	    claim_fft_machinery(other_size, MACH_IN_USE))
+		return other_size;
+	return NULL;
+}
+
+void size_vochorus_pool(struct vochorus_pool* pool, const double fft_size_arg)
+{
+	const unsigned fft_size = check_vochorus_fft_size(fft_size_arg);
+	for (size_t i = 0; i < MAX_POLY; i++) {
+		struct warpy_fft_machinery* fft_mach = &pool->machs[i];
+		if (!claim_fft_machinery(fft_mach, MACH_RESIZING))
+			continue;
+		resize_warpy_fft(fft_mach, fft_size);
+		__atomic_store_n(&fft_mach->state, MACH_FREE, __ATOMIC_RELEASE);
+	}
+}
+
+bool start_vochorus(struct vochorus* p,
+                    struct vochorus_pool* pool,
+                    const uint32_t output_cnt,
+                    const bool low_latency,
+                    const double interpolation_arg)
+{
+	// the size has to have been set with set_vochorus_size already
+	p->output_cnt = output_cnt;
+
+	struct warpy_fft_machinery* fft_mach = acquire_fft_machinery(pool,
+	                                                             p->fft_size);
+	if (fft_mach == NULL) {
+		__atomic_fetch_add(&pool->dropped, 1, __ATOMIC_RELAXED);
+		p->fft_mach = NULL;
+		p->stand_in = false;
+	}
+	else {
+		p->stand_in = fft_mach->fft_size != p->fft_size;
+		if (p->stand_in) {
+			p->fft_size = fft_mach->fft_size;
+			p->hop_size = p->fft_size / p->overlap;
+		}
+		p->fft_mach = fft_mach;
+		p->frames = fft_mach->frames;
+		init_out_frames(p);
+	}
+
+	p->out_frames_pos = 0;
+	p->up_to_hop_size = 0;
+	p->first_run = true;
+	p->time_domain = false;
+	p->has_last_grain = false;
+	p->last_grain = 0;
+	p->last_onset = -1;
+	p->low_latency = low_latency;
+	p->interpolation = check_interpolation(interpolation_arg);
+	p->sample = NULL;
+	p->onsets = NULL;
+	p->onset_cnt = 0;
+	p->envelopes = NULL;
+	p->envelope_cnt = 0;
+	p->no_of_c_voices = 0;
+
+	return p->fft_mach != NULL;
+}
+
+void stop_vochorus(struct vochorus* p)
+{
+	if (p->fft_mach != NULL)
+		__atomic_store_n(&p->fft_mach->state,
+		                 MACH_FREE,
+		                 __ATOMIC_RELEASE);
+	p->fft_mach = NULL;
+}
+
+void set_vochorus_input(struct vochorus* p,
+                        const struct vochorus_input* input,
+                        const double env_samp_rate)
+{
+	const double rate_adjust = input->sample_rate / env_samp_rate;
+	p->env_samp_rate = env_samp_rate;
+	p->sample = input->sample;
+	p->sample_len = input->sample_len;
+	p->onsets = input->onsets;
+	p->onset_cnt = input->onset_cnt;
+	p->envelopes = input->envelopes;
+	p->envelope_cnt = input->envelope_cnt;
+	p->rate_adjust = rate_adjust;
+	p->pitch = input->pitch * rate_adjust;
+	p->no_of_c_voices = (size_t)input->chorus_voices;
+	p->mix = input->mix;
+	p->detune = input->detune;
+	p->spread = input->spread;
+	p->main_channel_pan = input->main_channel_pan;
+}
+
+void run_vochorus(struct vochorus* p,
+                  const double* seek_points,
+                  double* const* out,
+                  const size_t offset,
+                  const size_t nsmps)
+{
+	if (p->fft_mach == NULL)
+		return;
+
+	for (size_t n = offset; n < nsmps; n++) {
+		const bool first_run = p->first_run;
+		const unsigned up_to_hop_size = p->up_to_hop_size;
+		if (first_run && p->low_latency)
+			preroll(p, seek_points[n]);
+		if (first_run || up_to_hop_size == p->hop_size) {
+			p->first_run = false;
+			run_frame(p, seek_points[n], 0);
+		}
+		write_to_output(p, out, n);
+		p->up_to_hop_size++;
+	}
+}
@@ -0,0 +1,176 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef e4b0c2d79a1f4c3e8d6b5a0f2c7e9d13
+#define e4b0c2d79a1f4c3e8d6b5a0f2c7e9d13
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// the vocoder and chorus without any Csound in it, so that both the
+// vochorus opcode and the native voice engine can drive it
+
+#define MAX_OUTS 2
+
+#define MAX_POLY 30
+#define MAX_CHORUS_VOICES 6
+
+#define MIN_FFT_SIZE     1024
+#define MAX_FFT_SIZE     16384
+#define DEFAULT_FFT_SIZE 4096
+// Hann squared only sums to a constant from an overlap of 4
+#define MIN_OVERLAP      4
+#define MAX_OVERLAP      16
+#define DEFAULT_OVERLAP  8
+
+#define INTERP_LINEAR  0
+#define INTERP_HERMITE 1
+#define INTERP_SINC    2
+
+#define LEFT_ONLY 0
+#define RIGHT_ONLY 1
+#define BOTH_CHANNELS 2
+
+#define VOCHORUS_ENVELOPE_BINS 129
+
+struct warpy_fft_machinery;
+struct vochorus_pool;
+
+// overlap-add rings of fft_size samples, lent by the pool's machinery for
+// as long as the vochorus holds it: each frame is added in where it starts
+// playing and every sample is cleared once it has been read out
+struct vochorus_frames {
+	double* center;
+	double* chor_l;
+	double* chor_r;
+};
+
+// changes every control period
+struct vochorus_input {
+	const double* sample;
+	size_t        sample_len;
+	double        sample_rate;
+	double        pitch;
+	double        chorus_voices;
+	double        mix;
+	double        detune;
+	double        spread;
+	unsigned      main_channel_pan;
+	// sorted sample positions where grains keep their own phases, or NULL
+	const size_t* onsets;
+	size_t        onset_cnt;
+	// from analyse_vochorus_envelopes, or NULL to let formants move with
+	// the pitch
+	const double* envelopes;
+	size_t        envelope_cnt;
+};
+
+struct vochorus {
+	bool                 first_run;
+	bool                 low_latency;
+	unsigned             interpolation;
+	uint32_t             output_cnt;
+	size_t               out_frames_pos;
+	size_t               up_to_hop_size;
+	// whether the last frame skipped the FFTs, and where it read from
+	bool                 time_domain;
+	bool                 has_last_grain;
+	int64_t              last_grain;
+	// the onset the phases were last reset at, or -1
+	int64_t              last_onset;
+	struct vochorus_frames frames;
+
+	struct warpy_fft_machinery* fft_mach;
+	// the machinery hadn't been replanned for the size asked for yet, so
+	// the vochorus runs at the size it has
+	bool                 stand_in;
+
+	double               env_samp_rate;
+	const double*        sample;
+	size_t               sample_len;
+	const size_t*        onsets;
+	size_t               onset_cnt;
+	const double*        envelopes;
+	size_t               envelope_cnt;
+	double               rate_adjust;
+	double               pitch;
+	size_t               no_of_c_voices;
+	double               mix;
+	double               detune;
+	double               spread;
+	unsigned             main_channel_pan;
+	unsigned             fft_size;
+	unsigned             overlap;
+	unsigned             hop_size;
+};
+
+// NULL if there isn't the memory for every machinery
+struct vochorus_pool* create_vochorus_pool(void);
+void destroy_vochorus_pool(struct vochorus_pool* pool);
+// how many notes found all the machinery busy since the last call, which
+// the audio thread can't stop to print
+size_t take_vochorus_dropped(struct vochorus_pool* pool);
+// replans the machinery no note is using for a new FFT size, which is
+// too slow for the audio thread; machinery that was busy needs another
+// call once its note is done
+void size_vochorus_pool(struct vochorus_pool* pool, double fft_size_arg);
+void import_vochorus_wisdom(void);
+void export_vochorus_wisdom(void);
+
+// spectral flux onsets of the two channels mixed, for the analysis to
+// reset its phases at; slow enough to belong wherever the sample is
+// decoded. false if there wasn't the memory for it
+bool detect_vochorus_onsets(const double* left,
+                            const double* right,
+                            size_t len,
+                            double sample_rate,
+                            size_t** onsets,
+                            size_t* onset_cnt);
+
+// cepstrally smoothed log magnitude spectra of the two channels mixed,
+// VOCHORUS_ENVELOPE_BINS from 0 to the sample's Nyquist per frame, for
+// putting the formants back where they were after a pitch shift. false
+// if there wasn't the memory for it
+bool analyse_vochorus_envelopes(const double* left,
+                                const double* right,
+                                size_t len,
+                                double** envelopes,
+                                size_t* envelope_cnt);
+
+// what set_vochorus_size will actually use for the sizes asked for
+unsigned check_vochorus_fft_size(double fft_size_arg);
+unsigned check_vochorus_overlap(double overlap_arg);
+void set_vochorus_size(struct vochorus* p,
+                       double fft_size_arg,
+                       double overlap_arg);
+bool start_vochorus(struct vochorus* p,
+                    struct vochorus_pool* pool,
+                    uint32_t output_cnt,
+                    bool low_latency,
+                    double interpolation_arg);
+void stop_vochorus(struct vochorus* p);
+void set_vochorus_input(struct vochorus* p,
+                        const struct vochorus_input* input,
+                        double env_samp_rate);
+void run_vochorus(struct vochorus* p,
+                  const double* seek_points,
+                  double* const* out,
+                  size_t offset,
+                  size_t nsmps);
+
+#endif
@@ -15,11 +15,11 @@ module ERBUtils
   end
 
   def sustain_on
-    "ksustainsection == 1"
+    "(gksustainsection == 1)"
   end
 
   def release_on
-    "kreleasesection == 1"
+    "(gkreleasesection == 1)"
   end
 
   def in_sustain_phase
@@ -39,6 +39,14 @@ module ERBUtils
     POINTER
   end
 
+  # speed and pitch in one vocparams call
+  def speed_and_pitch(vartype, outtype: 'k')
+    speed = VocoderParams.new('speed', vartype)
+    pitch = VocoderParams.new('pitch', vartype)
+    "#{outtype}speedfinal, #{outtype}pitchfinal vocparams " +
+      "#{speed.inputs}, #{pitch.inputs}, imfreq"
+  end
+
   def kline(_start, _end)
     "(1 / (gisampledur * (#{_end} - #{_start}) / kspeedfinal)) / kr"
   end
@@ -89,6 +97,31 @@ module ERBUtils
       "#{file_channel}, 1, #{MINCER_FFT_SIZE}, #{MINCER_DECIM}"
   end
 
+  # one note instrument per channel count of the sample, which only a load
+  # changes; vibrato and the release section stay branches on every
+  # k-cycle so that held notes follow them. warpy.c works out the same
+  # numbers and points massign at the one that matches
+  class NoteVariant
+    FIRST_INSTR = 2
+
+    attr_reader :stereo
+    def initialize(stereo:)
+      @stereo = stereo
+    end
+
+    def self.all
+      [false, true].map {|s| new(stereo: s)}
+    end
+
+    def self.active_notes
+      all.map {|variant| "active:i(#{variant.number})"}.join(' + ')
+    end
+
+    def number
+      FIRST_INSTR + (stereo ? 1 : 0)
+    end
+  end
+
   class VocoderParams
     attr_reader :vartype, :param
     def initialize(param, vartype)
@@ -107,9 +140,15 @@ module ERBUtils
       VOC
     end
 
-    def vocparam
+    def inputs
+      "#{prefix}adjust, #{prefix}center, " +
+        "#{prefix}lowerscale, #{prefix}upperscale"
+    end
+
+    # the inputs can be globals read elsewhere, the result is always per note
+    def vocparam(outtype: 'k')
       <<~VOC
-        #{prefix}final vocparam #{prefix}adjust, #{prefix}center, \
+        #{outtype}#{param}final vocparam #{prefix}adjust, #{prefix}center, \
                                 #{prefix}lowerscale, #{prefix}upperscale, \
                                 imfreq
       VOC
@@ -0,0 +1,184 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dlfcn.h>
+
+#include "rt_check.h"
+
+// linked into a test, these take the place of libc's for every library
+// in the process, and abort if they're called on the audio thread; gcc
+// turns some printfs into puts or fwrite, so those are caught as well
+
+// glibc's own allocator, which unlike dlsym can't allocate on the way
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t cnt, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void  __libc_free(void* ptr);
+
+#define NEXT(symbol) \
+	static __typeof__(symbol)* next_##symbol; \
+	if (!next_##symbol) \
+		next_##symbol = (__typeof__(symbol)*)dlsym(RTLD_NEXT, #symbol)
+
+static __thread unsigned realtime_depth;
+
+void enter_realtime(void)
+{
+	realtime_depth++;
+}
+
+void leave_realtime(void)
+{
+	realtime_depth--;
+}
+
+// stderr may be the very thing allocating, so this only writes
+static void check_realtime(const char* call)
+{
+	if (realtime_depth == 0)
+		return;
+	const char* const parts[] = {
+		"WARPY RT CHECK: ", call, " on the audio thread\n"
+	};
+	for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+		const ssize_t written = write(STDERR_FILENO,
+		                              parts[i],
+		                              strlen(parts[i]));
+		(void)written;
+	}
+	abort();
+}
+
+void* malloc(size_t size)
+{
+	check_realtime("malloc");
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t cnt, size_t size)
+{
+	check_realtime("calloc");
+	return __libc_calloc(cnt, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+	check_realtime("realloc");
+	return __libc_realloc(ptr, size);
+}
+
+// free(NULL) does nothing, wherever it runs
+void free(void* ptr)
+{
+	if (ptr)
+		check_realtime("free");
+	__libc_free(ptr);
+}
+
+// FFTW allocates through these
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+	check_realtime("posix_memalign");
+	void* const aligned = __libc_memalign(alignment, size);
+	if (!aligned)
+		return ENOMEM;
+	*ptr = aligned;
+	return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+	check_realtime("aligned_alloc");
+	return __libc_memalign(alignment, size);
+}
+
+FILE* fopen(const char* path, const char* mode)
+{
+	check_realtime("fopen");
+	NEXT(fopen);
+	return next_fopen(path, mode);
+}
+
+int vfprintf(FILE* stream, const char* format, va_list args)
+{
+	check_realtime("vfprintf");
+	NEXT(vfprintf);
+	return next_vfprintf(stream, format, args);
+}
+
+int fprintf(FILE* stream, const char* format, ...)
+{
+	check_realtime("fprintf");
+	va_list args;
+	va_start(args, format);
+	const int written = vfprintf(stream, format, args);
+	va_end(args);
+	return written;
+}
+
+int printf(const char* format, ...)
+{
+	check_realtime("printf");
+	va_list args;
+	va_start(args, format);
+	const int written = vfprintf(stdout, format, args);
+	va_end(args);
+	return written;
+}
+
+int puts(const char* string)
+{
+	check_realtime("puts");
+	NEXT(puts);
+	return next_puts(string);
+}
+
+int putchar(int c)
+{
+	check_realtime("putchar");
+	NEXT(putchar);
+	return next_putchar(c);
+}
+
+int fputs(const char* string, FILE* stream)
+{
+	check_realtime("fputs");
+	NEXT(fputs);
+	return next_fputs(string, stream);
+}
+
+int fputc(int c, FILE* stream)
+{
+	check_realtime("fputc");
+	NEXT(fputc);
+	return next_fputc(c, stream);
+}
+
+size_t fwrite(const void* ptr, size_t size, size_t cnt, FILE* stream)
+{
+	check_realtime("fwrite");
+	NEXT(fwrite);
+	return next_fwrite(ptr, size, cnt, stream);
+}
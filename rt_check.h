@@ -0,0 +1,34 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef a895eff64f92492db77050b2b5063c7c
+#define a895eff64f92492db77050b2b5063c7c
+
+// built with WARPY_RT_CHECK, anything that allocates, frees or touches a
+// file between enter_realtime and leave_realtime aborts, which is how the
+// tests show the audio thread never does; otherwise both cost nothing.
+// the Csound backend runs outside them, it allocates as it performs
+
+#ifdef WARPY_RT_CHECK
+void enter_realtime(void);
+void leave_realtime(void);
+#else
+static inline void enter_realtime(void) {}
+static inline void leave_realtime(void) {}
+#endif
+
+#endif
@@ -0,0 +1,333 @@
+/*
+ * This file is part of Warpy.
+ *
+ * Warpy is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Warpy is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Warpy.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "midi.h"
+
+#define MAX_EVENTS 64
+
+struct events {
+	struct midi_event list[MAX_EVENTS];
+	size_t            cnt;
+};
+
+static int failures = 0;
+
+static void collect(void* data, const struct midi_event* event)
+{
+	struct events* events = (struct events*)data;
+	if (events->cnt < MAX_EVENTS)
+		events->list[events->cnt++] = *event;
+}
+
+static void feed(struct midi_input* input,
+                 struct events* events,
+                 const uint8_t* bytes,
+                 size_t size)
+{
+	read_midi_bytes(input, bytes, size, collect, events);
+}
+
+static void check(bool ok, const char* test, const char* what)
+{
+	if (ok)
+		return;
+	fprintf(stderr, "FAIL %s: %s\n", test, what);
+	failures++;
+}
+
+static void check_event(const char* test,
+                        const struct events* events,
+                        size_t i,
+                        enum midi_event_type type,
+                        uint8_t channel,
+                        uint8_t note,
+                        uint8_t velocity)
+{
+	if (i >= events->cnt) {
+		check(false, test, "missing event");
+		return;
+	}
+	const struct midi_event* event = &events->list[i];
+	check(event->type == type, test, "type");
+	check(event->channel == channel, test, "channel");
+	check(event->note == note, test, "note");
+	check(event->velocity == velocity, test, "velocity");
+}
+
+static void start(struct midi_input* input, struct events* events)
+{
+	reset_midi_input(input);
+	events->cnt = 0;
+}
+
+static void test_note_on_and_off(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = { 0x90, 60, 100, 0x80, 60, 64 };
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 2, __func__, "event count");
+	check_event(__func__, &events, 0, MIDI_NOTE_ON, 0, 60, 100);
+	check_event(__func__, &events, 1, MIDI_NOTE_OFF, 0, 60, 64);
+}
+
+static void test_running_status(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = { 0x93, 60, 100, 64, 90, 60, 0 };
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 3, __func__, "event count");
+	check_event(__func__, &events, 0, MIDI_NOTE_ON, 3, 60, 100);
+	check_event(__func__, &events, 1, MIDI_NOTE_ON, 3, 64, 90);
+	check_event(__func__, &events, 2, MIDI_NOTE_OFF, 3, 60, 0);
+}
+
+static void test_split_across_calls(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t first[] = { 0x90, 60 };
+	const uint8_t second[] = { 100, 62 };
+	const uint8_t third[] = { 80 };
+	feed(&input, &events, first, sizeof(first));
+	check(events.cnt == 0, __func__, "half a message is no event");
+	feed(&input, &events, second, sizeof(second));
+	feed(&input, &events, third, sizeof(third));
+	check(events.cnt == 2, __func__, "event count");
+	check_event(__func__, &events, 0, MIDI_NOTE_ON, 0, 60, 100);
+	check_event(__func__, &events, 1, MIDI_NOTE_ON, 0, 62, 80);
+}
+
+static void test_stray_note_off(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = { 0x80, 60, 0, 0x90, 61, 0 };
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 0, __func__, "notes that never started");
+}
+
+static void test_repeated_note_on(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = { 0x90, 60, 100, 60, 50, 0x80, 60, 0, 0x80, 60, 0 };
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 4, __func__, "event count");
+	check_event(__func__, &events, 0, MIDI_NOTE_ON, 0, 60, 100);
+	check_event(__func__, &events, 1, MIDI_NOTE_OFF, 0, 60, 0);
+	check_event(__func__, &events, 2, MIDI_NOTE_ON, 0, 60, 50);
+	check_event(__func__, &events, 3, MIDI_NOTE_OFF, 0, 60, 0);
+}
+
+static void test_channels_are_separate(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = { 0x90, 60, 100, 0x81, 60, 0, 0x91, 60, 90 };
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 2, __func__, "event count");
+	check_event(__func__, &events, 0, MIDI_NOTE_ON, 0, 60, 100);
+	check_event(__func__, &events, 1, MIDI_NOTE_ON, 1, 60, 90);
+	check(input.held[0][60] == 100, __func__, "channel 1 still held");
+	check(input.held[1][60] == 90, __func__, "channel 2 held");
+}
+
+static void test_system_messages(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	// a clock tick mid message, then sysex ending running status
+	const uint8_t bytes[] = {
+		0x90, 60, 0xf8, 100,
+		0xf0, 0x7e, 60, 100, 0xf7,
+		62, 100,
+		0x90, 62, 100
+	};
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 2, __func__, "event count");
+	check_event(__func__, &events, 0, MIDI_NOTE_ON, 0, 60, 100);
+	check_event(__func__, &events, 1, MIDI_NOTE_ON, 0, 62, 100);
+}
+
+static void test_all_notes_off(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = {
+		0x92, 60, 100, 67, 100,
+		0xb2, MIDI_CC_ALL_NOTES_OFF, 0
+	};
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 5, __func__, "event count");
+	check_event(__func__, &events, 2, MIDI_NOTE_OFF, 2, 60, 0);
+	check_event(__func__, &events, 3, MIDI_NOTE_OFF, 2, 67, 0);
+	check_event(__func__, &events, 4, MIDI_CONTROL, 2,
+	            MIDI_CC_ALL_NOTES_OFF, 0);
+	check(input.held[2][60] == 0 && input.held[2][67] == 0,
+	      __func__,
+	      "nothing held");
+}
+
+static void test_short_messages(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = { 0xc5, 3, 4, 0xe5, 0x00, 0x40, 0x7f, 0x7f };
+	feed(&input, &events, bytes, sizeof(bytes));
+	check(events.cnt == 4, __func__, "event count");
+	check_event(__func__, &events, 0, MIDI_PROGRAM, 5, 3, 0);
+	check_event(__func__, &events, 1, MIDI_PROGRAM, 5, 4, 0);
+	check(events.cnt > 2 && events.list[2].type == MIDI_PITCH_BEND &&
+	      events.list[2].bend == 0,
+	      __func__,
+	      "centered bend");
+	check(events.cnt > 3 && events.list[3].bend == 8191,
+	      __func__,
+	      "full bend");
+}
+
+static void test_write_round_trip(void)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	const uint8_t bytes[] = {
+		0x94, 60, 100, 60, 0,
+		0xc4, 9,
+		0xe4, 0x12, 0x34
+	};
+	feed(&input, &events, bytes, sizeof(bytes));
+
+	uint8_t written[MAX_EVENTS * MIDI_EVENT_BYTES];
+	size_t size = 0;
+	for (size_t i = 0; i < events.cnt; i++)
+		size += write_midi_event(&events.list[i], &written[size]);
+	const uint8_t expected[] = {
+		0x94, 60, 100, 0x84, 60, 0,
+		0xc4, 9,
+		0xe4, 0x12, 0x34
+	};
+	check(size == sizeof(expected) && !memcmp(written, expected, size),
+	      __func__,
+	      "bytes");
+}
+
+static void express(struct midi_expression_state* state,
+                    const uint8_t* bytes,
+                    size_t size)
+{
+	struct midi_input input;
+	struct events events;
+	start(&input, &events);
+	feed(&input, &events, bytes, size);
+	for (size_t i = 0; i < events.cnt; i++)
+		read_midi_expression(state, &events.list[i]);
+}
+
+static void test_bend_range(void)
+{
+	struct midi_expression_state state;
+	reset_midi_expression(&state);
+	const uint8_t bytes[] = {
+		0xe2, 0x7f, 0x7f,
+		0xb5, 101, 0, 100, 0, 6, 12,
+		0xe5, 0x00, 0x00
+	};
+	express(&state, bytes, sizeof(bytes));
+	check(state.channels[2].bend > 1.99 && state.channels[2].bend < 2,
+	      __func__,
+	      "default range");
+	check(state.channels[5].bend == -12, __func__, "set range");
+}
+
+static void test_pressure_outside_mpe(void)
+{
+	struct midi_expression_state state;
+	reset_midi_expression(&state);
+	const uint8_t bytes[] = { 0xd1, 0, 0xb1, 74, 127 };
+	express(&state, bytes, sizeof(bytes));
+	check(state.channels[1].pressure == 1, __func__, "pressure");
+	check(state.channels[1].slide == 0, __func__, "slide");
+}
+
+static void test_mpe_zones(void)
+{
+	struct midi_expression_state state;
+	reset_midi_expression(&state);
+	const uint8_t bytes[] = {
+		0xb0, 101, 0, 100, 6, 6, 3,
+		0xbf, 101, 0, 100, 6, 6, 15,
+		0xb0, 101, 0, 100, 6, 6, 3,
+		0xd2, 0,
+		0xb2, 74, 0,
+		0xe2, 0x00, 0x00
+	};
+	express(&state, bytes, sizeof(bytes));
+	check(state.lower_members == 3, __func__, "lower members");
+	check(state.upper_members == 11, __func__, "upper members");
+	check(!state.mpe_member[0] && state.mpe_member[3] &&
+	      state.mpe_member[4] && state.mpe_member[14] &&
+	      !state.mpe_member[15],
+	      __func__,
+	      "members");
+	check(state.channels[2].pressure == 0, __func__, "pressure");
+	check(state.channels[3].pressure == 0 &&
+	      state.channels[0].pressure == 1,
+	      __func__,
+	      "pressure before any");
+	check(state.channels[2].slide == -1, __func__, "slide");
+	check(state.channels[2].bend == -48, __func__, "bend");
+}
+
+int main(void)
+{
+	test_note_on_and_off();
+	test_running_status();
+	test_split_across_calls();
+	test_stray_note_off();
+	test_repeated_note_on();
+	test_channels_are_separate();
+	test_system_messages();
+	test_all_notes_off();
+	test_short_messages();
+	test_write_round_trip();
+	test_bend_range();
+	test_pressure_outside_mpe();
+	test_mpe_zones();
+
+	if (failures) {
+		fprintf(stderr, "%d MIDI checks failed\n", failures);
+		return 1;
+	}
+	printf("MIDI checks passed\n");
+	return 0;
+}
@@ -4,6 +4,7 @@
 #include <unistd.h>
 
 #include "warpy.h"
+#include "rt_check.h"
 #include "test/tinywav/tinywav.h"
 
 #define SAMPLE_RATE 48000
@@ -189,14 +190,59 @@ void play_test(struct warpy* warpy)
 		samples[sample_addr+1] = sample.right;
 	}
 
+	struct warpy_warnings warnings = take_warpy_warnings(warpy);
+	report_warpy_warnings(&warnings);
+
 	write_wav(warpy, samples, length);
 	free(samples);
 }
 
+// moves the FFT size and the render cache while notes play, the way a
+// plugin host would: the ports are read on the audio thread, and the
+// replanning and the arena are left to a worker outside it
+void move_settings_test(struct warpy* warpy)
+{
+	uint8_t on[] =  {  note_on(0x34) };
+	uint8_t off[] = { note_off(0x34) };
+
+	int length = 3 * SAMPLE_RATE;
+	for (int i = 0; i < length; i++) {
+		const unsigned fft_size = i < length / 3 ? 4096 : 1024;
+		const float render_cache = i < length / 2 ? 0 : 16;
+
+		enter_realtime();
+		const bool fft_size_moved = update_fft_size(warpy, fft_size);
+		const bool render_cache_moved = update_render_cache(warpy,
+		                                                    render_cache);
+		update_fft_overlap(warpy, i < length / 3 ? 8 : 4);
+		update_chorus_voices(warpy, i < length / 2 ? 2 : 0);
+		if (i % (SAMPLE_RATE / 2) == 0)
+			send_midi_message(warpy, on, 3);
+		else if (i % (SAMPLE_RATE / 2) == SAMPLE_RATE / 4)
+			send_midi_message(warpy, off, 3);
+		gen_sample(warpy);
+		leave_realtime();
+
+		if (fft_size_moved)
+			prepare_fft_machinery(warpy);
+		if (render_cache_moved) {
+			struct warpy_load* load =
+			        prepare_render_cache_load(warpy, render_cache);
+			enter_realtime();
+			struct warpy_load* replaced = finish_load(warpy, load);
+			leave_realtime();
+			free_load(replaced);
+		}
+	}
+}
+
 int main(int argc, char* argv[]) {
 	struct warpy* warpy = create_warpy(SAMPLE_RATE);
 	bool result = start_warpy(warpy);
-	if (result) play_test(warpy);
+	if (result) {
+		play_test(warpy);
+		move_settings_test(warpy);
+	}
 	stop_warpy(warpy);
 	destroy_warpy(warpy);
 
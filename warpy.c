@@ -16,21 +16,26 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <errno.h>
 #include <math.h>
 #include <unistd.h>
+#include <time.h>
 #include <csound/csound.h>
 #include <sox.h>
 
 #include "warpy.h"
-#include "chorus_scales.h"
+#include "engine.h"
+#include "keymap.h"
+#include "midi.h"
+#include "rt_check.h"
+#include "opcodes/vochorus.h"
 
 #define CONTROL_PERIOD_FRAMES 64
-#define MIDI_MESSAGE_BUFFER_SIZE 4096
-#define MIDI_CACHE_LENGTH 256
+#define MIDI_EVENT_QUEUE_SIZE 4096
 #define MIN_BOUNDS_SIZE 0.0001
+#define UNSET_PARAM -100
 
 struct scale {
 	const double floor;
@@ -60,48 +65,19 @@ static const char WARPY_ORC[] = {
 	#include "warpy.orc.xxd"
 };
 
-struct midi_message {
-	uint8_t* raw_message;
-	uint64_t size;
+// parsed as it arrives, and played at the start of the next control period
+struct midi_event_queue {
+	struct midi_event events[MIDI_EVENT_QUEUE_SIZE];
+	uint32_t          cnt;
+	uint32_t          dropped;
 };
 
-struct midi_message_buffer {
-	struct midi_message* messages;
-	uint32_t size;
-	uint32_t pos;
-};
-
-static void clear_midi_message(struct midi_message* message)
-{
-	uint8_t empty[] = { 0x00 };
-	message->raw_message = empty;
-	message->size = 0;
-}
-
-static struct midi_message_buffer* create_midi_message_buffer(void)
-{
-	struct midi_message_buffer* message_buffer =
-	        (struct midi_message_buffer*)
-	        malloc(sizeof(struct midi_message_buffer));
-	struct midi_message* messages =
-	        (struct midi_message*)
-	        calloc(MIDI_MESSAGE_BUFFER_SIZE, sizeof(struct midi_message));
-	message_buffer->messages = messages;
-	message_buffer->size = MIDI_MESSAGE_BUFFER_SIZE;
-	message_buffer->pos = 0;
-	return message_buffer;
-}
-
-static void destroy_midi_message_buffer(struct midi_message_buffer* buffer)
-{
-	free(buffer->messages);
-	free(buffer);
-}
-
 static struct audio_sample* create_audio_sample(void)
 {
 	struct audio_sample* audio_sample =
 	        (struct audio_sample*)malloc(sizeof(struct audio_sample));
+	if (!audio_sample)
+		return NULL;
 	audio_sample->left = 0;
 	audio_sample->right = 0;
 	return audio_sample;
@@ -112,20 +88,36 @@ struct param {
 	const char* channel;
 	float arg;
 	MYFLT result;
+	MYFLT quality_scale;
 	bool is_cs_current;
 };
 
-struct param* create_param(MYFLT (*calc)(float), const char* channel)
+struct param* create_param(MYFLT (*calc)(float),
+                           const char* channel,
+                           bool* no_memory)
 {
 	struct param* param = (struct param*)malloc(sizeof(struct param));
+	if (!param) {
+		*no_memory = true;
+		return NULL;
+	}
 	param->calc = calc;
 	param->channel = channel;
-	param->arg = -100;
-	param->result = -100;
+	param->arg = UNSET_PARAM;
+	param->result = UNSET_PARAM;
+	param->quality_scale = 1;
 	param->is_cs_current = false;
 	return param;
 }
 
+static inline MYFLT param_value(const struct param* param)
+{
+	// an unset param reads as 0, like an unset channel
+	if (param->arg == UNSET_PARAM)
+		return 0;
+	return param->result * param->quality_scale;
+}
+
 struct bounds create_bounds(struct param* start, struct param* end)
 {
 	struct bounds bounds;
@@ -305,8 +297,6 @@ static MYFLT scale_vibrato_freq(float freq)
 	return (MYFLT)freq * VIB_FREQ_MAX;
 }
 
-#define MAX_CHORUS_VOICES 6
-
 static MYFLT check_chorus_voices(float voices)
 {
 	if (voices < 0)
@@ -316,6 +306,26 @@ static MYFLT check_chorus_voices(float voices)
 	return voices;
 }
 
+static MYFLT check_fft_size(float size)
+{
+	return check_vochorus_fft_size(size);
+}
+
+static MYFLT check_fft_overlap(float overlap)
+{
+	return check_vochorus_overlap(overlap);
+}
+
+#define INTERPOLATION_MODE_COUNT (INTERP_SINC + 1)
+
+static MYFLT check_interpolation(float mode)
+{
+	unsigned mode_int = (unsigned)mode;
+	if (mode_int >= INTERPOLATION_MODE_COUNT)
+		mode_int = INTERPOLATION_MODE_COUNT - 1;
+	return mode_int;
+}
+
 static const unsigned tempo_frac_denoms[] = {1,  2,  3,  4,  6,  8,
                                              9, 12, 16, 27, 32, 81};
 static const unsigned tempo_frac_denoms_len = sizeof(tempo_frac_denoms) /
@@ -331,7 +341,7 @@ static MYFLT get_vib_tempo_frac(float denom_indx)
 }
 
 struct cache {
-	uint32_t path_int;
+	uint64_t path_hash;
 	struct param* gain;
 	struct param* bps;
 	struct param* speed_adjust;
@@ -367,82 +377,21 @@ struct cache {
 	struct param* vibrato_tempo_toggle;
 	struct param* vibrato_freq;
 	struct param* vibrato_tempo_fraction;
+	struct param* vibrato_retrigger;
 	struct param* chorus_voices;
 	struct param* chorus_mix;
 	struct param* chorus_detune;
 	struct param* chorus_spread;
 	struct param* note_pan_center;
 	struct param* note_pan_amt;
+	struct param* fft_size;
+	struct param* fft_overlap;
+	struct param* low_latency;
+	struct param* interpolation;
+	struct param* preserve_transients;
+	struct param* preserve_formants;
 };
 
-struct cache* create_cache(void)
-{
-	struct cache* cache = (struct cache*)calloc(1, sizeof(struct cache));
-	cache->speed_adjust = create_param(&calc_speed_adjust, "speed_adjust");
-	cache->speed_center = create_param(&check_midi_note_range,
-	                                   "speed_center");
-	cache->speed_lower_scale = create_param(&check_scale_range,
-	                                        "speed_lower_scale");
-	cache->speed_upper_scale = create_param(&check_scale_range,
-	                                        "speed_upper_scale");
-	cache->pitch_adjust = create_param(&calc_pitch_adjust, "pitch_adjust");
-	cache->pitch_center = create_param(&check_midi_note_range,
-	                                   "pitch_center");
-	cache->pitch_lower_scale = create_param(&check_scale_range,
-	                                        "pitch_lower_scale");
-	cache->pitch_upper_scale = create_param(&check_scale_range,
-	                                        "pitch_upper_scale");
-	cache->gain = create_param(&calc_gain, "gain");
-	cache->bps = create_param(&bpm_to_bps, "bps");
-	cache->env_attack_time   = create_param(NULL, "env_attack_time");
-	cache->env_attack_shape  = create_param(NULL, "env_attack_shape");
-	cache->env_decay_time    = create_param(NULL, "env_decay_time");
-	cache->env_decay_shape   = create_param(NULL, "env_decay_shape");
-	cache->env_sustain_level = create_param(NULL, "env_sustain_level");
-	cache->env_release_time  = create_param(NULL, "env_release_time");
-	cache->env_release_shape = create_param(NULL, "env_release_shape");
-	cache->reverse = create_param(&check_bool, "reverse");
-	cache->loop_times = create_param(NULL, "loop_times");
-	cache->start_point = create_param(&check_start, "start_point");
-	cache->end_point   = create_param(&check_end, "end_point");
-	cache->sustain_section     = create_param(&check_bool,
-	                                          "sustain_section");
-	cache->tie_sustain_end_to_main_end = create_param(&check_bool,
-	                                         "tie_sustain_end_to_main_end");
-	cache->sustain_start_point = create_param(&check_start,
-	                                          "sustain_start_point");
-	cache->sustain_end_point   = create_param(&check_end,
-	                                          "sustain_end_point");
-	cache->release_section     = create_param(&check_bool,
-	                                          "release_section");
-	cache->tie_release_start_to_main_end = create_param(&check_bool,
-	                                       "tie_release_start_to_main_end");
-	cache->release_start_point = create_param(&check_start,
-	                                          "release_start_point");
-	cache->release_end_point   = create_param(&check_end,
-	                                          "release_end_point");
-	cache->release_loop_times  = create_param(NULL,
-	                                          "release_loop_times");
-	cache->vibrato_amp = create_param(&scale_vibrato_amp,
-	                                  "vibrato_amp");
-	cache->vibrato_waveform_type = create_param(&check_vib_wave_type,
-	                                             "vibrato_waveform_type");
-	cache->vibrato_tempo_toggle = create_param(&check_bool,
-	                                           "vibrato_tempo_toggle");
-	cache->vibrato_freq = create_param(&scale_vibrato_freq,
-	                                   "vibrato_freq");
-	cache->vibrato_tempo_fraction = create_param(&get_vib_tempo_frac,
-	                                             "vibrato_tempo_fraction");
-	cache->chorus_voices = create_param(&check_chorus_voices,
-	                                    "chorus_voices");
-	cache->chorus_mix    = create_param(NULL, "chorus_mix");
-	cache->chorus_detune = create_param(NULL, "chorus_detune");
-	cache->chorus_spread = create_param(NULL, "chorus_spread");
-	cache->note_pan_center = create_param(NULL, "note_pan_center");
-	cache->note_pan_amt = create_param(NULL, "note_pan_amt");
-	return cache;
-}
-
 void destroy_cache(struct cache* cache)
 {
 	free(cache->gain);
@@ -480,35 +429,309 @@ void destroy_cache(struct cache* cache)
 	free(cache->vibrato_tempo_toggle);
 	free(cache->vibrato_freq);
 	free(cache->vibrato_tempo_fraction);
+	free(cache->vibrato_retrigger);
 	free(cache->chorus_voices);
 	free(cache->chorus_mix);
 	free(cache->chorus_detune);
 	free(cache->chorus_spread);
 	free(cache->note_pan_center);
 	free(cache->note_pan_amt);
+	free(cache->fft_size);
+	free(cache->fft_overlap);
+	free(cache->low_latency);
+	free(cache->preserve_transients);
+	free(cache->preserve_formants);
+	free(cache->interpolation);
 	free(cache);
 }
 
+struct cache* create_cache(void)
+{
+	struct cache* cache = (struct cache*)calloc(1, sizeof(struct cache));
+	if (!cache)
+		return NULL;
+	bool no_memory = false;
+	cache->speed_adjust = create_param(&calc_speed_adjust, "speed_adjust",
+	                                   &no_memory);
+	cache->speed_center = create_param(&check_midi_note_range,
+	                                   "speed_center", &no_memory);
+	cache->speed_lower_scale = create_param(&check_scale_range,
+	                                        "speed_lower_scale",
+	                                        &no_memory);
+	cache->speed_upper_scale = create_param(&check_scale_range,
+	                                        "speed_upper_scale",
+	                                        &no_memory);
+	cache->pitch_adjust = create_param(&calc_pitch_adjust, "pitch_adjust",
+	                                   &no_memory);
+	cache->pitch_center = create_param(&check_midi_note_range,
+	                                   "pitch_center", &no_memory);
+	cache->pitch_lower_scale = create_param(&check_scale_range,
+	                                        "pitch_lower_scale",
+	                                        &no_memory);
+	cache->pitch_upper_scale = create_param(&check_scale_range,
+	                                        "pitch_upper_scale",
+	                                        &no_memory);
+	cache->gain = create_param(&calc_gain, "gain", &no_memory);
+	cache->bps = create_param(&bpm_to_bps, "bps", &no_memory);
+	cache->env_attack_time   = create_param(NULL, "env_attack_time",
+	                                        &no_memory);
+	cache->env_attack_shape  = create_param(NULL, "env_attack_shape",
+	                                        &no_memory);
+	cache->env_decay_time    = create_param(NULL, "env_decay_time",
+	                                        &no_memory);
+	cache->env_decay_shape   = create_param(NULL, "env_decay_shape",
+	                                        &no_memory);
+	cache->env_sustain_level = create_param(NULL, "env_sustain_level",
+	                                        &no_memory);
+	cache->env_release_time  = create_param(NULL, "env_release_time",
+	                                        &no_memory);
+	cache->env_release_shape = create_param(NULL, "env_release_shape",
+	                                        &no_memory);
+	cache->reverse = create_param(&check_bool, "reverse", &no_memory);
+	cache->loop_times = create_param(NULL, "loop_times", &no_memory);
+	cache->start_point = create_param(&check_start, "start_point",
+	                                  &no_memory);
+	cache->end_point   = create_param(&check_end, "end_point", &no_memory);
+	cache->sustain_section     = create_param(&check_bool,
+	                                          "sustain_section",
+	                                          &no_memory);
+	cache->tie_sustain_end_to_main_end = create_param(&check_bool,
+	                                         "tie_sustain_end_to_main_end",
+	                                         &no_memory);
+	cache->sustain_start_point = create_param(&check_start,
+	                                          "sustain_start_point",
+	                                          &no_memory);
+	cache->sustain_end_point   = create_param(&check_end,
+	                                          "sustain_end_point",
+	                                          &no_memory);
+	cache->release_section     = create_param(&check_bool,
+	                                          "release_section",
+	                                          &no_memory);
+	cache->tie_release_start_to_main_end = create_param(&check_bool,
+	                                       "tie_release_start_to_main_end",
+	                                       &no_memory);
+	cache->release_start_point = create_param(&check_start,
+	                                          "release_start_point",
+	                                          &no_memory);
+	cache->release_end_point   = create_param(&check_end,
+	                                          "release_end_point",
+	                                          &no_memory);
+	cache->release_loop_times  = create_param(NULL,
+	                                          "release_loop_times",
+	                                          &no_memory);
+	cache->vibrato_amp = create_param(&scale_vibrato_amp,
+	                                  "vibrato_amp", &no_memory);
+	cache->vibrato_waveform_type = create_param(&check_vib_wave_type,
+	                                             "vibrato_waveform_type",
+	                                             &no_memory);
+	cache->vibrato_tempo_toggle = create_param(&check_bool,
+	                                           "vibrato_tempo_toggle",
+	                                           &no_memory);
+	cache->vibrato_freq = create_param(&scale_vibrato_freq,
+	                                   "vibrato_freq", &no_memory);
+	cache->vibrato_tempo_fraction = create_param(&get_vib_tempo_frac,
+	                                             "vibrato_tempo_fraction",
+	                                             &no_memory);
+	cache->vibrato_retrigger = create_param(&check_bool,
+	                                        "vibrato_retrigger",
+	                                        &no_memory);
+	cache->chorus_voices = create_param(&check_chorus_voices,
+	                                    "chorus_voices", &no_memory);
+	cache->chorus_mix    = create_param(NULL, "chorus_mix", &no_memory);
+	cache->chorus_detune = create_param(NULL, "chorus_detune", &no_memory);
+	cache->chorus_spread = create_param(NULL, "chorus_spread", &no_memory);
+	cache->note_pan_center = create_param(NULL, "note_pan_center",
+	                                      &no_memory);
+	cache->note_pan_amt = create_param(NULL, "note_pan_amt", &no_memory);
+	cache->fft_size = create_param(&check_fft_size, "fft_size", &no_memory);
+	cache->fft_overlap = create_param(&check_fft_overlap, "fft_overlap",
+	                                  &no_memory);
+	cache->low_latency = create_param(&check_bool, "low_latency",
+	                                  &no_memory);
+	cache->interpolation = create_param(&check_interpolation,
+	                                    "interpolation", &no_memory);
+	cache->preserve_transients = create_param(&check_bool,
+	                                          "preserve_transients",
+	                                          &no_memory);
+	cache->preserve_formants = create_param(&check_bool,
+	                                        "preserve_formants",
+	                                        &no_memory);
+
+	if (no_memory) {
+		destroy_cache(cache);
+		return NULL;
+	}
+	return cache;
+}
+
+#define MAX_POLYPHONY 30
+
+struct quality_tier {
+	MYFLT chorus_voices;
+	MYFLT fft_overlap;
+	MYFLT max_polyphony;
+};
+
+// from full quality down, each tier scales the user's settings; a
+// polyphony of 0 means no cap beyond the vochorus pool
+static const struct quality_tier QUALITY_TIERS[] = {
+	{ .chorus_voices = 1,   .fft_overlap = 1,   .max_polyphony = 0 },
+	{ .chorus_voices = 0.5, .fft_overlap = 1,   .max_polyphony = 0 },
+	{ .chorus_voices = 0,   .fft_overlap = 1,   .max_polyphony = 0 },
+	{ .chorus_voices = 0,   .fft_overlap = 0.5, .max_polyphony = 0 },
+	{ .chorus_voices = 0,   .fft_overlap = 0.5,
+	  .max_polyphony = MAX_POLYPHONY / 2 }
+};
+
+#define QUALITY_TIER_COUNT \
+	(sizeof(QUALITY_TIERS) / sizeof(struct quality_tier))
+
+#define LOAD_SMOOTHING 0.05
+#define LOAD_RESTORE_RATIO 0.6
+#define TIER_SETTLE_PERIODS 64
+#define TIER_RESTORE_PERIODS 1024
+
+struct load_monitor {
+	double budget; // usecs per control period, 0 when disabled
+	double load;   // smoothed usecs per control period
+	unsigned tier;
+	uint32_t periods_since_change;
+	uint32_t periods_under;
+};
+
+// the orchestra has a note instrument for mono and for stereo samples,
+// numbered the same way as NoteVariant in rake/orc_file_erb.rb; a mono
+// note no longer carries the two vochorus opcodes it never runs
+#define FIRST_NOTE_INSTR     2
+#define NOTE_VARIANT_STEREO  1
+
+// the ports a part can set for its channel, going through the same calc
+// function as the port itself
+struct part_param {
+	const char* symbol;
+	size_t      cache_offset;
+	bool        negate;
+	size_t      settings_offset;
+};
+
+#define PART_PARAM(symbol, cache_field, negate, settings_field) \
+	{ symbol, \
+	  offsetof(struct cache, cache_field), \
+	  negate, \
+	  offsetof(struct engine_settings, settings_field) }
+
+static const struct part_param PART_PARAMS[] = {
+	PART_PARAM("speed_adjust", speed_adjust, false, speed_adjust),
+	PART_PARAM("speed_center", speed_center, false, speed_center),
+	PART_PARAM("speed_lower_scale", speed_lower_scale, true,
+	           speed_lower_scale),
+	PART_PARAM("speed_upper_scale", speed_upper_scale, false,
+	           speed_upper_scale),
+	PART_PARAM("pitch_adjust", pitch_adjust, false, pitch_adjust),
+	PART_PARAM("pitch_center", pitch_center, false, pitch_center),
+	PART_PARAM("pitch_lower_scale", pitch_lower_scale, true,
+	           pitch_lower_scale),
+	PART_PARAM("pitch_upper_scale", pitch_upper_scale, false,
+	           pitch_upper_scale),
+	PART_PARAM("attack_time", env_attack_time, false, env_attack_time),
+	PART_PARAM("attack_shape", env_attack_shape, false, env_attack_shape),
+	PART_PARAM("decay_time", env_decay_time, false, env_decay_time),
+	PART_PARAM("decay_shape", env_decay_shape, false, env_decay_shape),
+	PART_PARAM("sustain_level", env_sustain_level, false,
+	           env_sustain_level),
+	PART_PARAM("release_time", env_release_time, false, env_release_time),
+	PART_PARAM("release_shape", env_release_shape, false,
+	           env_release_shape),
+	PART_PARAM("reverse", reverse, false, reverse),
+	PART_PARAM("loop_times", loop_times, false, loop_times),
+	PART_PARAM("chorus_voices", chorus_voices, false, chorus_voices),
+	PART_PARAM("chorus_mix", chorus_mix, false, chorus_mix),
+	PART_PARAM("chorus_detune", chorus_detune, false, chorus_detune),
+	PART_PARAM("chorus_stereo_spread", chorus_spread, false,
+	           chorus_spread),
+	PART_PARAM("note_pan_center", note_pan_center, false,
+	           note_pan_center),
+	PART_PARAM("note_pan_amt", note_pan_amt, false, note_pan_amt)
+};
+
+#define PART_PARAM_CNT (sizeof(PART_PARAMS) / sizeof(struct part_param))
+
+// the calc functions have already run by the time a part reaches the
+// audio thread, only the quality tier is left to apply
+struct part_override {
+	const struct param* param;
+	size_t              settings_offset;
+	MYFLT               value;
+};
+
+struct warpy_parts {
+	struct part_override overrides[ENGINE_CHANNELS][PART_PARAM_CNT];
+	size_t               override_cnt[ENGINE_CHANNELS];
+	// channels the parts file has a section for, which keep their own
+	// sound through program changes
+	bool                 own_part[ENGINE_CHANNELS];
+};
+
 struct warpy {
 	CSOUND* csound;
 	double sample_rate;
 	int channels;
-	struct midi_message_buffer* midi_message_buffer;
-	bool* midi_cache;
+	struct midi_input midi_input;
+	struct midi_event_queue* midi_events;
+	struct midi_expression_state midi_expression;
 	struct audio_sample* audio_sample;
 	CSOUND_PARAMS* params;
 	uint32_t control_period_frames;
 	uint32_t audio_buffer_pos;
 	bool never_run;
 	struct cache* cache;
+	struct load_monitor load_monitor;
+	int backend;
+	struct engine* engine;
+	struct engine_settings settings;
+	struct warpy_parts* parts;
+	struct engine_settings part_settings[ENGINE_CHANNELS];
+	const struct engine_settings* channel_settings[ENGINE_CHANNELS];
+	double* native_out[2];
+	bool sample_stereo;
+	int note_variant;
+	float preset;
+	double sample_version;
+	float render_cache_mb;
+	// loads that finished before there was an engine to swap them into
+	struct warpy_load* pending_loose;
+	struct warpy_load* pending_bank;
+	struct warpy_load* pending_parts;
+	struct warpy_load* pending_render_cache;
+};
+
+struct warpy_load {
+	int                  kind;
+	char*                path;
+	uint64_t             path_hash;
+	uint64_t             identity;
+	uint64_t             hash;
+	// the orchestra's length and channel count, read along with the load
+	bool                 has_header;
+	bool                 sample_stereo;
+	double               sample_dur;
+	struct keymap*       keymap;
+	struct engine_bank*  bank;
+	struct engine_parts* parts;
+	struct warpy_parts*  part_settings;
+	struct engine_render_cache* render_cache;
 };
 
 struct warpy* create_warpy(double sample_rate)
 {
 	struct warpy* warpy = (struct warpy*)malloc(sizeof(struct warpy));
+	if (!warpy)
+		return NULL;
 	warpy->sample_rate = sample_rate;
-	warpy->midi_message_buffer = create_midi_message_buffer();
-	warpy->midi_cache = (bool*)calloc(MIDI_CACHE_LENGTH, sizeof(bool));
+	reset_midi_input(&warpy->midi_input);
+	reset_midi_expression(&warpy->midi_expression);
+	warpy->midi_events = (struct midi_event_queue*)
+	        calloc(1, sizeof(struct midi_event_queue));
 	warpy->audio_sample = create_audio_sample();
 	int channels = 2;
 	warpy->channels = channels;
@@ -516,11 +739,58 @@ struct warpy* create_warpy(double sample_rate)
 	warpy->audio_buffer_pos = 0;
 	warpy->never_run = true;
 	warpy->cache = create_cache();
-	warpy->csound = csoundCreate(warpy);
+	warpy->load_monitor = (struct load_monitor){ 0 };
+	warpy->backend = WARPY_BACKEND_NATIVE;
+	warpy->engine = NULL;
+	warpy->settings = (struct engine_settings){ 0 };
+	warpy->parts = NULL;
+	for (size_t i = 0; i < ENGINE_CHANNELS; i++)
+		warpy->channel_settings[i] = &warpy->settings;
+	warpy->native_out[0] = (double*)calloc(CONTROL_PERIOD_FRAMES,
+	                                       sizeof(double));
+	warpy->native_out[1] = (double*)calloc(CONTROL_PERIOD_FRAMES,
+	                                       sizeof(double));
+	warpy->sample_stereo = false;
+	warpy->preset = -1;
+	warpy->sample_version = 0;
+	warpy->render_cache_mb = 0;
+	warpy->pending_loose = NULL;
+	warpy->pending_bank = NULL;
+	warpy->pending_parts = NULL;
+	warpy->pending_render_cache = NULL;
+	warpy->note_variant = FIRST_NOTE_INSTR;
+	warpy->csound = NULL;
 	warpy->params = (CSOUND_PARAMS*)malloc(sizeof(CSOUND_PARAMS));
+
+	if (!warpy->midi_events || !warpy->audio_sample || !warpy->cache ||
+	    !warpy->native_out[0] || !warpy->native_out[1] || !warpy->params) {
+		destroy_warpy(warpy);
+		return NULL;
+	}
 	return warpy;
 }
 
+static inline bool uses_csound(const struct warpy* warpy)
+{
+	return warpy->backend == WARPY_BACKEND_CSOUND;
+}
+
+void select_backend(struct warpy* warpy, int backend)
+{
+	// only before start_warpy
+	if (backend == WARPY_BACKEND_CSOUND) {
+		warpy->backend = WARPY_BACKEND_CSOUND;
+		if (!warpy->csound)
+			warpy->csound = csoundCreate(warpy);
+	} else {
+		warpy->backend = WARPY_BACKEND_NATIVE;
+		if (warpy->csound) {
+			csoundDestroy(warpy->csound);
+			warpy->csound = NULL;
+		}
+	}
+}
+
 static inline void check_cache(struct param* param, float new_arg)
 {
 	if (!(param->arg == new_arg)) {
@@ -539,17 +809,22 @@ static void update_against_cache(struct warpy* warpy,
 {
 	check_cache(param, new_arg);
 
+	// the native engine reads the cache directly
+	if (!uses_csound(warpy))
+		return;
+
 	if (!param->is_cs_current) {
+		MYFLT value = param_value(param);
 		MYFLT cs_current_val =
 			csoundGetControlChannel(warpy->csound,
 			                        param->channel,
 			                        NULL);
-		if (param->result == cs_current_val)
+		if (value == cs_current_val)
 			param->is_cs_current = true;
 		else
 			csoundSetControlChannel(warpy->csound,
 			                        param->channel,
-			                        param->result);
+			                        value);
 	}
 }
 
@@ -567,7 +842,8 @@ static bool ensure_status(const int status,
 	}
 }
 
-static const char* KEEP_RUNNING = "i \"PathGetter\" 0 z\n";
+static const char* KEEP_RUNNING = "i 1 0 z\n"
+                                  "i \"PathGetter\" 0 z\n";
 
 static int open_input_device(CSOUND* csound,
                              void** user_data,
@@ -581,71 +857,29 @@ static int open_input_device(CSOUND* csound,
 	return 0;
 }
 
-static bool midi_cache_get(struct warpy* warpy,
-                           uint8_t* message,
-                           uint64_t size)
-{
-	bool* cache = warpy->midi_cache;
-	if (size >= 2 && message[0] == 0x90) {
-		uint8_t note = message[1];
-		return cache[note];
-	}
-	return false;
-}
-
-static void midi_cache_set(struct warpy* warpy,
-                           uint8_t* message,
-                           uint64_t size)
-{
-	bool* cache = warpy->midi_cache;
-	if (size >= 2) {
-		uint8_t note = message[0];
-		if      (message[0] == 0x90)
-			cache[note] = true;
-		else if (message[0] == 0x80)
-			cache[note] = false;
-	}
-}
-
+// Csound only takes bytes, so the events go back to tidy ones: every
+// message with its status, and note off as 0x80
 static int read_midi_data(CSOUND* csound,
                           void* user_data,
                           unsigned char *buffer,
                           int space_in_buffer)
 {
 	struct warpy* warpy = (struct warpy*)user_data;
-	uint64_t total_bytes = 0;
-	struct midi_message* midi_buffer = warpy->midi_message_buffer->messages;
-	uint32_t buffer_pos = warpy->midi_message_buffer->pos;
+	struct midi_event_queue* queue = warpy->midi_events;
+	int total_bytes = 0;
 	uint32_t i;
-	for (i = 0; i < buffer_pos; i++) {
-		struct midi_message message = midi_buffer[i];
-		if (message.size > UINT32_MAX) {
-			fprintf(stderr, "MIDI messages must fit in 32 bytes\n");
-			return -(abs(EINVAL));
-		}
-
-		uint32_t size = (uint32_t)message.size;
-
-		if ((int64_t)space_in_buffer - size < 0) {
-			fprintf(stderr, "No space left in Csound MIDI buffer\n");
-			return -(abs(CSOUND_MEMORY));
-		}
-
-		if (size && !midi_cache_get(warpy,
-		                            message.raw_message,
-		                            message.size)) {
-			for (uint32_t i = 0; i < size; i++)
-				*buffer++ = message.raw_message[i];
-			midi_cache_set(warpy,
-			               message.raw_message,
-			               message.size);
-			clear_midi_message(&midi_buffer[i]);
-			total_bytes += size;
-		}
+	for (i = 0; i < queue->cnt; i++) {
+		if (space_in_buffer - total_bytes < MIDI_EVENT_BYTES)
+			break;
+		total_bytes += write_midi_event(&queue->events[i],
+		                                &buffer[total_bytes]);
 	}
 
-	warpy->midi_message_buffer->pos = 0;
-
+	// whatever didn't fit goes in the next read
+	queue->cnt -= i;
+	memmove(queue->events,
+	        &queue->events[i],
+	        sizeof(struct midi_event) * queue->cnt);
 	return total_bytes;
 }
 
@@ -700,8 +934,35 @@ static inline void register_opcodes(CSOUND* csound)
 	//csoundSetMessageLevel(csound, 0);
 }
 
+static void finish_pending_load(struct warpy* warpy,
+                                struct warpy_load** pending)
+{
+	struct warpy_load* load = *pending;
+	*pending = NULL;
+	if (load)
+		free_load(finish_load(warpy, load));
+}
+
+static bool start_native(struct warpy* warpy)
+{
+	if (!warpy->engine)
+		warpy->engine = create_engine(warpy->sample_rate,
+		                              CONTROL_PERIOD_FRAMES);
+	if (!warpy->engine)
+		return false;
+	prepare_fft_machinery(warpy);
+	finish_pending_load(warpy, &warpy->pending_loose);
+	finish_pending_load(warpy, &warpy->pending_bank);
+	finish_pending_load(warpy, &warpy->pending_parts);
+	finish_pending_load(warpy, &warpy->pending_render_cache);
+	return true;
+}
+
 bool start_warpy(struct warpy* warpy)
 {
+	if (!uses_csound(warpy))
+		return start_native(warpy);
+
 	CSOUND* csound = warpy->csound;
 
 	set_up_midi(csound);
@@ -718,6 +979,9 @@ bool start_warpy(struct warpy* warpy)
 	                   "Problem with dummy score\n",
 	                   csound))
 		return false;
+	warpy->note_variant = FIRST_NOTE_INSTR;
+	// a reset cleared the path channel
+	warpy->cache->path_hash = 0;
 	int startstatus = csoundStart(csound);
 	if (!ensure_status(startstatus,
 	                   "Csound failed to start\n",
@@ -727,9 +991,299 @@ bool start_warpy(struct warpy* warpy)
 	return true;
 }
 
+static void rescale_param(struct warpy* warpy,
+                          struct param* param,
+                          MYFLT quality_scale)
+{
+	if (param->quality_scale == quality_scale)
+		return;
+	param->quality_scale = quality_scale;
+	param->is_cs_current = false;
+	if (param->result >= 0)
+		update_against_cache(warpy, param, param->arg);
+}
+
+static void apply_quality_tier(struct warpy* warpy, unsigned tier)
+{
+	const struct quality_tier* settings = &QUALITY_TIERS[tier];
+	struct cache* cache = warpy->cache;
+
+	// a held note keeps the overlap it started with, and vochorus
+	// scales the overlap-add to it, so a tier change doesn't step the
+	// level of what is already playing. the overlap only has a channel
+	// once the host has set it
+	if (settings->fft_overlap != 1 && cache->fft_overlap->result < 0)
+		check_cache(cache->fft_overlap, DEFAULT_OVERLAP);
+
+	rescale_param(warpy, cache->chorus_voices, settings->chorus_voices);
+	rescale_param(warpy, cache->fft_overlap, settings->fft_overlap);
+	if (uses_csound(warpy))
+		csoundSetControlChannel(warpy->csound,
+		                        "max_polyphony",
+		                        settings->max_polyphony);
+
+	warpy->load_monitor.tier = tier;
+	warpy->load_monitor.periods_since_change = 0;
+	warpy->load_monitor.periods_under = 0;
+}
+
+static inline double elapsed_usecs(const struct timespec* start,
+                                   const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e6
+	       + (end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+static void track_load(struct warpy* warpy, double usecs)
+{
+	struct load_monitor* monitor = &warpy->load_monitor;
+	monitor->load += (usecs - monitor->load) * LOAD_SMOOTHING;
+	monitor->periods_since_change++;
+
+	// give each step time to show up in the smoothed load before
+	// taking another, and only restore once load has stayed well under
+	// budget for a while so the tiers don't flap
+	if (monitor->periods_since_change < TIER_SETTLE_PERIODS)
+		return;
+
+	if (monitor->load > monitor->budget) {
+		monitor->periods_under = 0;
+		if (monitor->tier + 1 < QUALITY_TIER_COUNT)
+			apply_quality_tier(warpy, monitor->tier + 1);
+	} else if (monitor->load < monitor->budget * LOAD_RESTORE_RATIO) {
+		monitor->periods_under++;
+		if (monitor->tier > 0
+		    && monitor->periods_under >= TIER_RESTORE_PERIODS)
+			apply_quality_tier(warpy, monitor->tier - 1);
+	} else {
+		monitor->periods_under = 0;
+	}
+}
+
+// channels without overrides point straight at warpy->settings, which
+// lets the engine share their speed and pitch tables
+static void fill_part_settings(struct warpy* warpy)
+{
+	const struct warpy_parts* parts = warpy->parts;
+	for (size_t c = 0; c < ENGINE_CHANNELS; c++) {
+		if (!parts || parts->override_cnt[c] == 0) {
+			warpy->channel_settings[c] = &warpy->settings;
+			continue;
+		}
+
+		struct engine_settings* settings = &warpy->part_settings[c];
+		*settings = warpy->settings;
+		for (size_t i = 0; i < parts->override_cnt[c]; i++) {
+			const struct part_override* override =
+			        &parts->overrides[c][i];
+			*(double*)((char*)settings + override->settings_offset) =
+			        override->value * override->param->quality_scale;
+		}
+		warpy->channel_settings[c] = settings;
+	}
+}
+
+static void fill_engine_settings(struct warpy* warpy)
+{
+	const struct cache* cache = warpy->cache;
+	struct engine_settings* settings = &warpy->settings;
+	settings->bps                    = param_value(cache->bps);
+	settings->speed_adjust           = param_value(cache->speed_adjust);
+	settings->speed_center           = param_value(cache->speed_center);
+	settings->speed_lower_scale      = param_value(cache->speed_lower_scale);
+	settings->speed_upper_scale      = param_value(cache->speed_upper_scale);
+	settings->pitch_adjust           = param_value(cache->pitch_adjust);
+	settings->pitch_center           = param_value(cache->pitch_center);
+	settings->pitch_lower_scale      = param_value(cache->pitch_lower_scale);
+	settings->pitch_upper_scale      = param_value(cache->pitch_upper_scale);
+	settings->env_attack_time        = param_value(cache->env_attack_time);
+	settings->env_attack_shape       = param_value(cache->env_attack_shape);
+	settings->env_decay_time         = param_value(cache->env_decay_time);
+	settings->env_decay_shape        = param_value(cache->env_decay_shape);
+	settings->env_sustain_level      = param_value(cache->env_sustain_level);
+	settings->env_release_time       = param_value(cache->env_release_time);
+	settings->env_release_shape      = param_value(cache->env_release_shape);
+	settings->reverse                = param_value(cache->reverse);
+	settings->loop_times             = param_value(cache->loop_times);
+	settings->start_point            = param_value(cache->start_point);
+	settings->end_point              = param_value(cache->end_point);
+	settings->sustain_section        = param_value(cache->sustain_section);
+	settings->tie_sustain_end_to_main_end =
+	        param_value(cache->tie_sustain_end_to_main_end);
+	settings->sustain_start_point    = param_value(cache->sustain_start_point);
+	settings->sustain_end_point      = param_value(cache->sustain_end_point);
+	settings->release_section        = param_value(cache->release_section);
+	settings->tie_release_start_to_main_end =
+	        param_value(cache->tie_release_start_to_main_end);
+	settings->release_start_point    = param_value(cache->release_start_point);
+	settings->release_end_point      = param_value(cache->release_end_point);
+	settings->release_loop_times     = param_value(cache->release_loop_times);
+	settings->vibrato_amp            = param_value(cache->vibrato_amp);
+	settings->vibrato_waveform_type  =
+	        param_value(cache->vibrato_waveform_type);
+	settings->vibrato_tempo_toggle   = param_value(cache->vibrato_tempo_toggle);
+	settings->vibrato_freq           = param_value(cache->vibrato_freq);
+	settings->vibrato_tempo_fraction =
+	        param_value(cache->vibrato_tempo_fraction);
+	settings->vibrato_retrigger      = param_value(cache->vibrato_retrigger);
+	settings->chorus_voices          = param_value(cache->chorus_voices);
+	settings->chorus_mix             = param_value(cache->chorus_mix);
+	settings->chorus_detune          = param_value(cache->chorus_detune);
+	settings->chorus_spread          = param_value(cache->chorus_spread);
+	settings->note_pan_center        = param_value(cache->note_pan_center);
+	settings->note_pan_amt           = param_value(cache->note_pan_amt);
+	settings->fft_size               = param_value(cache->fft_size);
+	settings->fft_overlap            = param_value(cache->fft_overlap);
+	settings->low_latency            = param_value(cache->low_latency);
+	settings->interpolation          = param_value(cache->interpolation);
+	settings->preserve_transients    =
+	        param_value(cache->preserve_transients);
+	settings->preserve_formants      =
+	        param_value(cache->preserve_formants);
+	settings->max_polyphony          =
+	        QUALITY_TIERS[warpy->load_monitor.tier].max_polyphony;
+	fill_part_settings(warpy);
+}
+
+// how far full pressure takes a note over the level its velocity gave it
+#define PRESSURE_BOOST 1.0
+
+static void express_midi_channel(struct warpy* warpy, const uint8_t channel)
+{
+	const struct midi_expression* midi =
+	        &warpy->midi_expression.channels[channel];
+	// MPE controllers let pressure fall to 0 before the note off, so it
+	// can only add to the velocity, never take a note below it
+	const double pressure = warpy->midi_expression.mpe_member[channel] ?
+	                        midi->pressure : 0;
+	const struct engine_expression expression = {
+		.pitch = pow(2, midi->bend / 12),
+		// slide runs the sample from half to double speed
+		.speed = pow(2, midi->slide),
+		.gain  = 1 + PRESSURE_BOOST * pressure
+	};
+	express_channel(warpy->engine, channel, &expression);
+}
+
+static void read_expression(struct warpy* warpy,
+                            const struct midi_event* event)
+{
+	if (!read_midi_expression(&warpy->midi_expression, event))
+		return;
+	// data entry can set up an MPE zone, which resets every channel
+	if (event->type == MIDI_CONTROL && event->note == MIDI_CC_DATA_ENTRY)
+		for (uint8_t channel = 0; channel < MIDI_CHANNELS; channel++)
+			express_midi_channel(warpy, channel);
+	else
+		express_midi_channel(warpy, event->channel);
+}
+
+// the preset is every channel's without a part, so a part channel's
+// program changes are its own business
+static void select_midi_preset(struct warpy* warpy,
+                               const struct midi_event* event)
+{
+	const struct warpy_parts* parts = warpy->parts;
+	if (parts && parts->own_part[event->channel])
+		return;
+	select_engine_preset(warpy->engine, event->note);
+}
+
+static void dispatch_midi(struct warpy* warpy)
+{
+	// channels without a part play the same notes, like massign 0 in
+	// the orchestra
+	struct midi_event_queue* queue = warpy->midi_events;
+	for (uint32_t i = 0; i < queue->cnt; i++) {
+		const struct midi_event* event = &queue->events[i];
+		if (event->type == MIDI_NOTE_ON)
+			start_note(warpy->engine,
+			           warpy->channel_settings[event->channel],
+			           event->channel,
+			           event->note,
+			           event->velocity);
+		else if (event->type == MIDI_NOTE_OFF)
+			release_note(warpy->engine, event->channel, event->note);
+		else if (event->type == MIDI_PROGRAM)
+			select_midi_preset(warpy, event);
+		else
+			read_expression(warpy, event);
+	}
+	queue->cnt = 0;
+}
+
+static int note_variant(const struct warpy* warpy)
+{
+	int variant = FIRST_NOTE_INSTR;
+	if (warpy->sample_stereo)
+		variant += NOTE_VARIANT_STEREO;
+	return variant;
+}
+
+// new notes go to the variant without the branch on the channel count
+static void select_note_variant(struct warpy* warpy)
+{
+	const int variant = note_variant(warpy);
+	if (variant == warpy->note_variant)
+		return;
+
+	char event[32];
+	snprintf(event, sizeof(event), "i \"Router\" 0 0 %d\n", variant);
+	csoundInputMessage(warpy->csound, event);
+	warpy->note_variant = variant;
+}
+
+static void perform_control_period(struct warpy* warpy)
+{
+	if (uses_csound(warpy)) {
+		select_note_variant(warpy);
+		csoundPerformKsmps(warpy->csound);
+		return;
+	}
+
+	fill_engine_settings(warpy);
+	dispatch_midi(warpy);
+	run_engine(warpy->engine,
+	           &warpy->settings,
+	           warpy->channel_settings,
+	           warpy->native_out[0],
+	           warpy->native_out[1]);
+}
+
 static void run_warpy(struct warpy* warpy)
 {
-	csoundPerformKsmps(warpy->csound);
+	if (!(warpy->load_monitor.budget > 0)) {
+		perform_control_period(warpy);
+		return;
+	}
+
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	perform_control_period(warpy);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	track_load(warpy, elapsed_usecs(&start, &end));
+}
+
+// Csound allocates inside csoundPerformKsmps, and picking a note's
+// variant formats a score line, so only the native engine is checked
+static void run_warpy_realtime(struct warpy* warpy)
+{
+	if (uses_csound(warpy)) {
+		run_warpy(warpy);
+		return;
+	}
+	enter_realtime();
+	run_warpy(warpy);
+	leave_realtime();
+}
+
+static inline MYFLT output_sample(struct warpy* warpy, int channel)
+{
+	if (uses_csound(warpy))
+		return csoundGetSpoutSample(warpy->csound,
+		                            warpy->audio_buffer_pos,
+		                            channel);
+	return warpy->native_out[channel][warpy->audio_buffer_pos];
 }
 
 struct audio_sample gen_sample(struct warpy* warpy)
@@ -737,58 +1291,134 @@ struct audio_sample gen_sample(struct warpy* warpy)
 	struct audio_sample sample;
 
 	if (warpy->never_run) {
-		run_warpy(warpy);
+		run_warpy_realtime(warpy);
 		warpy->never_run = false;
 	}
 	else if (!(warpy->audio_buffer_pos < warpy->control_period_frames)) {
-		run_warpy(warpy);
+		run_warpy_realtime(warpy);
 		warpy->audio_buffer_pos = 0;
 	}
 
-	sample.left =
-	        (float)csoundGetSpoutSample(warpy->csound,
-	                                    warpy->audio_buffer_pos,
-	                                    0);
-	sample.right =
-	        (float)csoundGetSpoutSample(warpy->csound,
-	                                    warpy->audio_buffer_pos,
-	                                    1);
+	sample.left  = (float)output_sample(warpy, 0);
+	sample.right = (float)output_sample(warpy, 1);
 	warpy->audio_buffer_pos++;
 
 	return sample;
 }
 
-static bool space_left_in_midi_buffer(struct midi_message_buffer* buffer) {
-	return buffer->pos < buffer->size;
+static void queue_midi_event(void* data, const struct midi_event* event)
+{
+	struct midi_event_queue* queue = (struct midi_event_queue*)data;
+	if (queue->cnt == MIDI_EVENT_QUEUE_SIZE) {
+		queue->dropped++;
+		return;
+	}
+	queue->events[queue->cnt++] = *event;
 }
 
+// the bytes are only read here, so they needn't outlive the call
 void send_midi_message(struct warpy* warpy, uint8_t* raw, uint64_t size)
 {
-	if (!space_left_in_midi_buffer(warpy->midi_message_buffer)) {
+	enter_realtime();
+	read_midi_bytes(&warpy->midi_input,
+	                raw,
+	                size,
+	                queue_midi_event,
+	                warpy->midi_events);
+	leave_realtime();
+}
+
+// the opcode library keeps its pool in a Csound global
+static struct vochorus_pool* csound_pool(struct warpy* warpy)
+{
+	struct vochorus_pool** pool =
+	        (struct vochorus_pool**)csoundQueryGlobalVariable(warpy->csound,
+	                                                          "warpfft");
+	return pool ? *pool : NULL;
+}
+
+static size_t take_dropped_notes(struct warpy* warpy)
+{
+	if (!uses_csound(warpy))
+		return warpy->engine ? take_engine_dropped_notes(warpy->engine) : 0;
+	struct vochorus_pool* pool = csound_pool(warpy);
+	return pool ? take_vochorus_dropped(pool) : 0;
+}
+
+struct warpy_warnings take_warpy_warnings(struct warpy* warpy)
+{
+	struct warpy_warnings warnings;
+	warnings.dropped_midi = warpy->midi_events->dropped;
+	warnings.dropped_notes = take_dropped_notes(warpy);
+	warpy->midi_events->dropped = 0;
+	return warnings;
+}
+
+void report_warpy_warnings(const struct warpy_warnings* warnings)
+{
+	if (warnings->dropped_midi)
+		fprintf(stderr,
+		        "WARN: No space left in MIDI buffer; %u events discarded\n",
+		        warnings->dropped_midi);
+	if (warnings->dropped_notes)
 		fprintf(stderr,
-		        "WARN: No space left in MIDI buffer; \
-		        input discarded\n");
+		        "WARPY WARN: polyphony limit exceeded; %u notes dropped\n",
+		        warnings->dropped_notes);
+}
+
+void release_retired_samples(struct warpy* warpy)
+{
+	if (warpy->engine)
+		release_engine_retired(warpy->engine);
+}
+
+void prepare_fft_machinery(struct warpy* warpy)
+{
+	const MYFLT fft_size = param_value(warpy->cache->fft_size);
+	if (!uses_csound(warpy)) {
+		if (warpy->engine)
+			size_engine_machinery(warpy->engine, fft_size);
 		return;
 	}
-	struct midi_message* messages = warpy->midi_message_buffer->messages;
-	uint32_t* pos = &warpy->midi_message_buffer->pos;
-	messages[*pos].raw_message = raw;
-	messages[*pos].size = size;
-	(*pos)++;
+	struct vochorus_pool* pool = csound_pool(warpy);
+	if (pool)
+		size_vochorus_pool(pool, fft_size);
 }
 
 void stop_warpy(struct warpy* warpy)
 {
+	reset_midi_input(&warpy->midi_input);
+	reset_midi_expression(&warpy->midi_expression);
+	warpy->midi_events->cnt = 0;
+	if (!uses_csound(warpy)) {
+		if (warpy->engine) {
+			silence_engine(warpy->engine);
+			for (uint8_t channel = 0; channel < MIDI_CHANNELS; channel++)
+				express_midi_channel(warpy, channel);
+			release_engine_retired(warpy->engine);
+		}
+		return;
+	}
 	csoundCleanup(warpy->csound);
 	csoundReset(warpy->csound);
 }
 
 void destroy_warpy(struct warpy* warpy)
 {
-	csoundDestroy(warpy->csound);
-	destroy_midi_message_buffer(warpy->midi_message_buffer);
-	destroy_cache(warpy->cache);
-	free(warpy->midi_cache);
+	if (warpy->csound)
+		csoundDestroy(warpy->csound);
+	free_load(warpy->pending_loose);
+	free_load(warpy->pending_bank);
+	free_load(warpy->pending_parts);
+	free_load(warpy->pending_render_cache);
+	free(warpy->parts);
+	if (warpy->engine)
+		destroy_engine(warpy->engine);
+	free(warpy->native_out[0]);
+	free(warpy->native_out[1]);
+	free(warpy->midi_events);
+	if (warpy->cache)
+		destroy_cache(warpy->cache);
 	free(warpy->audio_sample);
 	free(warpy->params);
 	free(warpy);
@@ -800,8 +1430,11 @@ int get_channel_count(struct warpy* warpy)
 }
 
 #define PATH_CHANNEL "path"
+#define SAMPLE_VERSION_CHANNEL "sample_version"
 
-void update_sample_dur(struct warpy* warpy, const char* path)
+// sox_open_read is no place for the audio thread, so the orchestra's
+// sample_dur comes along with the load
+static void read_sample_header(struct warpy_load* load, const char* path)
 {
 	sox_format_t* header = sox_open_read(path, NULL, NULL, NULL);
 	if (!header) {
@@ -815,47 +1448,341 @@ void update_sample_dur(struct warpy* warpy, const char* path)
 	if (sample_rate < 1)
 		sample_rate = 1;
 	uint64_t frames = header->signal.length / channels;
-	double length_in_secs = (double)frames / sample_rate;
 	sox_close(header);
 
-	csoundSetControlChannel(warpy->csound, "sample_dur", length_in_secs);
+	load->has_header = true;
+	load->sample_stereo = channels > 1;
+	load->sample_dur = (double)frames / sample_rate;
 }
 
-void update_sample_path(struct warpy* warpy, char* path)
+void free_load(struct warpy_load* load)
 {
-	uint64_t i = 0;
-	char current = path[i];
-	uint32_t path_int = 0;
-	while (current != '\0'){
-		path_int += current;
-		if (path_int > UINT32_MAX) {
-			path_int = UINT32_MAX;
-			fprintf(stderr,
-				"WARN: saturating int conversion of %s at %d\n",
-				path,
-				UINT32_MAX);
-			break;
-		}
-		current = path[i++];
+	if (!load)
+		return;
+	free_engine_keymap(load->keymap);
+	free_engine_bank(load->bank);
+	free_engine_parts(load->parts);
+	free(load->part_settings);
+	free_engine_render_cache(load->render_cache);
+	free(load->path);
+	free(load);
+}
+
+uint64_t get_load_hash(const struct warpy_load* load)
+{
+	return load->hash;
+}
+
+uint64_t get_load_identity(const struct warpy_load* load)
+{
+	return load->identity;
+}
+
+static const struct part_param* find_part_param(const char* symbol)
+{
+	for (size_t i = 0; i < PART_PARAM_CNT; i++)
+		if (!strcmp(PART_PARAMS[i].symbol, symbol))
+			return &PART_PARAMS[i];
+	return NULL;
+}
+
+static void add_part_override(struct warpy_parts* parts,
+                              const size_t channel,
+                              const struct cache* cache,
+                              const struct part_setting* setting)
+{
+	const struct part_param* part_param = find_part_param(setting->name);
+	if (!part_param) {
+		fprintf(stderr,
+		        "WARN: channel %zu can't set %s\n",
+		        channel + 1,
+		        setting->name);
+		return;
+	}
+
+	const struct param* param =
+	        *(struct param* const*)((const char*)cache +
+	                                part_param->cache_offset);
+	const float arg = part_param->negate ? -setting->value : setting->value;
+	const MYFLT value = param->calc ? param->calc(arg) : arg;
+
+	// a setting given twice keeps the last value
+	size_t i = 0;
+	while (i < parts->override_cnt[channel] &&
+	       parts->overrides[channel][i].settings_offset !=
+	       part_param->settings_offset)
+		i++;
+	if (i == parts->override_cnt[channel])
+		parts->override_cnt[channel]++;
+	parts->overrides[channel][i] = (struct part_override){
+		.param           = param,
+		.settings_offset = part_param->settings_offset,
+		.value           = value
+	};
+}
+
+static struct warpy_parts* resolve_parts(const struct cache* cache,
+                                         const struct part_entry* entries)
+{
+	struct warpy_parts* parts =
+	        (struct warpy_parts*)calloc(1, sizeof(struct warpy_parts));
+	if (!parts)
+		return NULL;
+	for (size_t c = 0; c < ENGINE_CHANNELS; c++) {
+		parts->own_part[c] = entries[c].used;
+		for (size_t i = 0; i < entries[c].setting_cnt; i++)
+			add_part_override(parts, c, cache, &entries[c].settings[i]);
 	}
+	return parts;
+}
 
-	if (warpy->cache->path_int == path_int)
+static void prepare_parts(struct warpy* warpy,
+                          struct warpy_load* load,
+                          const char* path)
+{
+	struct part_entry* entries = read_parts(path);
+	if (!entries)
 		return;
-	else {
-		int64_t cs_path_size =
-		        csoundGetChannelDatasize(warpy->csound, PATH_CHANNEL);
-		if (cs_path_size) {
-			char cs_path[cs_path_size];
-			csoundGetStringChannel(warpy->csound, PATH_CHANNEL, cs_path);
-			if (!strcmp(path, cs_path)) {
-				warpy->cache->path_int = path_int;
-				return;
-			}
+	load->parts = prepare_engine_parts(entries);
+	load->part_settings = resolve_parts(warpy->cache, entries);
+	if (!load->part_settings) {
+		free_engine_parts(load->parts);
+		load->parts = NULL;
+	}
+	free_part_entries(entries);
+}
+
+static const char* describe_load_kind(const int kind)
+{
+	if (kind == WARPY_LOAD_KEYMAP)
+		return "keymaps";
+	if (kind == WARPY_LOAD_BANK)
+		return "preset banks";
+	return "parts";
+}
+
+// a bank keeps to the memory limit as it was when it started loading
+struct warpy_load* prepare_load(struct warpy* warpy,
+                                int kind,
+                                const char* path,
+                                uint64_t hash)
+{
+	if (uses_csound(warpy) && kind != WARPY_LOAD_SAMPLE) {
+		// zones need the native engine, the orchestra only has
+		// tables 1 and 2
+		fprintf(stderr,
+		        "WARN: %s need the native backend\n",
+		        describe_load_kind(kind));
+		return NULL;
+	}
+
+	struct warpy_load* load =
+	        (struct warpy_load*)calloc(1, sizeof(struct warpy_load));
+	if (!load)
+		return NULL;
+	load->kind = kind;
+	load->path = strdup(path);
+	if (!load->path) {
+		free_load(load);
+		return NULL;
+	}
+	load->path_hash = hash_sample_path(path);
+	load->hash = hash;
+	// the orchestra reads the file itself
+	if (uses_csound(warpy)) {
+		load->identity = get_sample_identity(path);
+		read_sample_header(load, path);
+		return load;
+	}
+
+	if (kind == WARPY_LOAD_SAMPLE) {
+		load->keymap = prepare_engine_sample(path, hash);
+		if (load->keymap) {
+			load->hash = get_engine_keymap_hash(load->keymap);
+			load->identity = get_engine_keymap_identity(load->keymap);
 		}
+	} else if (kind == WARPY_LOAD_KEYMAP) {
+		load->keymap = prepare_engine_keymap(path);
+	} else if (kind == WARPY_LOAD_BANK) {
+		const size_t budget = warpy->engine ?
+		                      get_engine_bank_budget(warpy->engine) : 0;
+		load->bank = prepare_engine_bank(path, budget);
+	} else {
+		prepare_parts(warpy, load, path);
+	}
+
+	if (!load->keymap && !load->bank && !load->parts) {
+		free_load(load);
+		return NULL;
+	}
+	return load;
+}
+
+// a new version reloads the tables even when the path stays the same
+static void load_csound_sample(struct warpy* warpy,
+                               const struct warpy_load* load)
+{
+	if (load->has_header) {
+		warpy->sample_stereo = load->sample_stereo;
+		csoundSetControlChannel(warpy->csound,
+		                        "sample_dur",
+		                        load->sample_dur);
+	}
+	csoundSetStringChannel(warpy->csound, PATH_CHANNEL, load->path);
+	csoundSetControlChannel(warpy->csound,
+	                        SAMPLE_VERSION_CHANNEL,
+	                        ++warpy->sample_version);
+}
+
+static struct warpy_load* finish_render_cache_load(struct warpy* warpy,
+                                                   struct warpy_load* load)
+{
+	if (!warpy->engine) {
+		struct warpy_load* replaced = warpy->pending_render_cache;
+		warpy->pending_render_cache = load;
+		return replaced;
 	}
+	load->render_cache = swap_engine_render_cache(warpy->engine,
+	                                              load->render_cache);
+	return load;
+}
+
+struct warpy_load* finish_load(struct warpy* warpy, struct warpy_load* load)
+{
+	if (load->kind == WARPY_LOAD_RENDER_CACHE)
+		return finish_render_cache_load(warpy, load);
+
+	if (load->kind == WARPY_LOAD_SAMPLE)
+		warpy->cache->path_hash = load->path_hash;
+	else if (load->kind == WARPY_LOAD_KEYMAP)
+		warpy->cache->path_hash = 0;
+
+	if (uses_csound(warpy)) {
+		load_csound_sample(warpy, load);
+		return load;
+	}
+
+	if (!warpy->engine) {
+		struct warpy_load** pending = &warpy->pending_loose;
+		if (load->kind == WARPY_LOAD_BANK)
+			pending = &warpy->pending_bank;
+		else if (load->kind == WARPY_LOAD_PARTS)
+			pending = &warpy->pending_parts;
+		struct warpy_load* replaced = *pending;
+		*pending = load;
+		return replaced;
+	}
+
+	if (load->parts) {
+		load->parts = swap_engine_parts(warpy->engine, load->parts);
+		struct warpy_parts* old = warpy->parts;
+		warpy->parts = load->part_settings;
+		load->part_settings = old;
+	} else if (load->bank) {
+		load->bank = swap_engine_bank(warpy->engine, load->bank);
+		if (warpy->preset >= 0)
+			select_engine_preset(warpy->engine,
+			                     (unsigned)warpy->preset);
+	} else {
+		load->keymap = swap_engine_keymap(warpy->engine, load->keymap);
+	}
+	return load;
+}
+
+static void load_now(struct warpy* warpy, int kind, const char* path)
+{
+	struct warpy_load* load = prepare_load(warpy, kind, path, 0);
+	if (load)
+		free_load(finish_load(warpy, load));
+	release_retired_samples(warpy);
+}
+
+bool is_current_sample(struct warpy* warpy, const char* path)
+{
+	return hash_sample_path(path) == warpy->cache->path_hash;
+}
+
+// a file that has gone missing is left alone rather than failing to
+// decode on every check
+bool has_sample_changed(const char* path, uint64_t identity)
+{
+	const uint64_t current = get_sample_identity(path);
+	return current != 0 && current != identity;
+}
+
+// an edited file under the same path is left to whoever checks
+// get_sample_identity in the background
+void update_sample_path(struct warpy* warpy, char* path)
+{
+	if (!is_current_sample(warpy, path))
+		load_now(warpy, WARPY_LOAD_SAMPLE, path);
+}
+
+void update_keymap_path(struct warpy* warpy, const char* path)
+{
+	load_now(warpy, WARPY_LOAD_KEYMAP, path);
+}
+
+void update_bank_path(struct warpy* warpy, const char* path)
+{
+	load_now(warpy, WARPY_LOAD_BANK, path);
+}
+
+void update_parts_path(struct warpy* warpy, const char* path)
+{
+	load_now(warpy, WARPY_LOAD_PARTS, path);
+}
+
+// the port only switches when it moves, so program changes stick
+void update_preset(struct warpy* warpy, float preset)
+{
+	if (preset == warpy->preset)
+		return;
+	warpy->preset = preset;
+	if (!uses_csound(warpy) && warpy->engine && preset >= 0)
+		select_engine_preset(warpy->engine, (unsigned)preset);
+}
+
+#define BYTES_PER_MB (1024.0 * 1024.0)
+
+void update_memory_limit(struct warpy* warpy, float megabytes)
+{
+	if (warpy->engine)
+		set_engine_memory_limit(warpy->engine,
+		                        megabytes > 0 ?
+		                        (size_t)(megabytes * BYTES_PER_MB) : 0);
+}
+
+// the orchestra has nothing to cache, so the size waits for the native
+// backend to come back
+bool update_render_cache(struct warpy* warpy, float megabytes)
+{
+	if (uses_csound(warpy) || megabytes == warpy->render_cache_mb)
+		return false;
+	warpy->render_cache_mb = megabytes;
+	return true;
+}
 
-	update_sample_dur(warpy, path);
-	csoundSetStringChannel(warpy->csound, PATH_CHANNEL, path);
+struct warpy_load* prepare_render_cache_load(struct warpy* warpy,
+                                             float megabytes)
+{
+	struct warpy_load* load =
+	        (struct warpy_load*)calloc(1, sizeof(struct warpy_load));
+	if (!load)
+		return NULL;
+	load->kind = WARPY_LOAD_RENDER_CACHE;
+	const size_t bytes = megabytes > 0 ?
+	                     (size_t)(megabytes * BYTES_PER_MB) : 0;
+	load->render_cache = prepare_engine_render_cache(bytes,
+	                                                 CONTROL_PERIOD_FRAMES);
+	return load;
+}
+
+float get_memory_used(struct warpy* warpy)
+{
+	if (!warpy->engine)
+		return 0;
+	return get_engine_memory(warpy->engine) / BYTES_PER_MB;
 }
 
 void update_vocoder_settings(struct warpy* warpy,
@@ -1024,6 +1951,11 @@ void update_vibrato_tempo_fraction(struct warpy* warpy, unsigned tempo_fraction)
 	update_against_cache(warpy, warpy->cache->vibrato_tempo_fraction, tempo_fraction);
 }
 
+void update_vibrato_retrigger(struct warpy* warpy, bool retrigger)
+{
+	update_against_cache(warpy, warpy->cache->vibrato_retrigger, retrigger);
+}
+
 void update_chorus_voices(struct warpy* warpy, unsigned voices)
 {
 	update_against_cache(warpy, warpy->cache->chorus_voices, voices);
@@ -1053,3 +1985,72 @@ void update_note_pan_amount(struct warpy* warpy, float amount)
 {
 	update_against_cache(warpy, warpy->cache->note_pan_amt, amount);
 }
+
+bool update_fft_size(struct warpy* warpy, unsigned size)
+{
+	const MYFLT before = param_value(warpy->cache->fft_size);
+	update_against_cache(warpy, warpy->cache->fft_size, size);
+	return param_value(warpy->cache->fft_size) != before;
+}
+
+void update_fft_overlap(struct warpy* warpy, unsigned overlap)
+{
+	update_against_cache(warpy, warpy->cache->fft_overlap, overlap);
+}
+
+void update_low_latency(struct warpy* warpy, bool low_latency)
+{
+	update_against_cache(warpy, warpy->cache->low_latency, low_latency);
+}
+
+void update_interpolation(struct warpy* warpy, unsigned mode)
+{
+	update_against_cache(warpy, warpy->cache->interpolation, mode);
+}
+
+// only the native engine has the onsets to reset at
+void update_preserve_transients(struct warpy* warpy, bool preserve)
+{
+	update_against_cache(warpy, warpy->cache->preserve_transients, preserve);
+}
+
+// likewise only the native engine has the envelopes
+void update_preserve_formants(struct warpy* warpy, bool preserve)
+{
+	update_against_cache(warpy, warpy->cache->preserve_formants, preserve);
+}
+
+// without the preroll a note fades in over its first window, so it only
+// reaches full level half a window late; the rounding of seek points to
+// the hop and of MIDI to the control period move each note by a different
+// amount, so there's nothing fixed there to compensate
+uint32_t get_latency(struct warpy* warpy)
+{
+	if (param_value(warpy->cache->low_latency) == 1)
+		return 0;
+	return (uint32_t)param_value(warpy->cache->fft_size) / 2;
+}
+
+void update_cpu_budget(struct warpy* warpy,
+                       float usecs_per_block,
+                       uint32_t block_frames)
+{
+	struct load_monitor* monitor = &warpy->load_monitor;
+	double budget = 0;
+	if (usecs_per_block > 0 && block_frames > 0)
+		budget = (double)usecs_per_block
+		         * warpy->control_period_frames / block_frames;
+
+	if (budget == monitor->budget)
+		return;
+	if (!(monitor->budget > 0))
+		monitor->load = 0;
+	monitor->budget = budget;
+	if (!(budget > 0) && monitor->tier != 0)
+		apply_quality_tier(warpy, 0);
+}
+
+unsigned get_quality_tier(struct warpy* warpy)
+{
+	return warpy->load_monitor.tier;
+}
@@ -21,11 +21,23 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "opcodes/vochorus.h"
+
 #define VOC_SPEED 0
 #define VOC_PITCH 1
 
+#define WARPY_BACKEND_NATIVE 0
+#define WARPY_BACKEND_CSOUND 1
+
+#define WARPY_LOAD_SAMPLE 0
+#define WARPY_LOAD_KEYMAP 1
+#define WARPY_LOAD_BANK   2
+#define WARPY_LOAD_PARTS  3
+#define WARPY_LOAD_RENDER_CACHE 4
+
 struct param;
 struct warpy;
+struct warpy_load;
 
 struct bounds {
 	struct param* start;
@@ -37,6 +49,12 @@ struct audio_sample {
 	float right;
 };
 
+// what the audio thread had to give up on, counted since it can't print
+struct warpy_warnings {
+	uint32_t dropped_midi;
+	uint32_t dropped_notes;
+};
+
 struct envelope {
 	float attack_time;
 	float attack_shape;
@@ -56,6 +74,7 @@ struct vocoder_settings {
 };
 
 struct warpy* create_warpy(double sample_rate);
+void select_backend(struct warpy* warpy, int backend);
 bool start_warpy(struct warpy* warpy);
 void stop_warpy(struct warpy* warpy);
 void destroy_warpy(struct warpy* warpy);
@@ -63,8 +82,42 @@ void destroy_warpy(struct warpy* warpy);
 void send_midi_message(struct warpy* warpy, uint8_t* raw, uint64_t size);
 struct audio_sample gen_sample(struct warpy* warpy);
 int get_channel_count(struct warpy* warpy);
+// take_warpy_warnings belongs on the audio thread and the other two off
+// it: the warnings go somewhere that can print them, and samples that
+// playing notes kept after their keymap went get freed
+struct warpy_warnings take_warpy_warnings(struct warpy* warpy);
+void report_warpy_warnings(const struct warpy_warnings* warnings);
+void release_retired_samples(struct warpy* warpy);
+// replans the FFTs no note is playing on for the fft_size setting, also
+// off the audio thread
+void prepare_fft_machinery(struct warpy* warpy);
+
+// prepare_load decodes and can run on a worker thread, finish_load swaps
+// the result in on the audio thread and hands back a load holding
+// whatever it replaced, for freeing off the audio thread again
+struct warpy_load* prepare_load(struct warpy* warpy,
+                                int kind,
+                                const char* path,
+                                uint64_t hash);
+struct warpy_load* finish_load(struct warpy* warpy, struct warpy_load* load);
+void free_load(struct warpy_load* load);
+uint64_t get_load_hash(const struct warpy_load* load);
+uint64_t get_load_identity(const struct warpy_load* load);
+bool is_current_sample(struct warpy* warpy, const char* path);
+bool has_sample_changed(const char* path, uint64_t identity);
 
 void update_sample_path(struct warpy* warpy, char* path);
+void update_keymap_path(struct warpy* warpy, const char* path);
+void update_bank_path(struct warpy* warpy, const char* path);
+void update_parts_path(struct warpy* warpy, const char* path);
+void update_preset(struct warpy* warpy, float preset);
+void update_memory_limit(struct warpy* warpy, float megabytes);
+// true when the size moved, and the arena for it has to come from
+// prepare_render_cache_load off the audio thread
+bool update_render_cache(struct warpy* warpy, float megabytes);
+struct warpy_load* prepare_render_cache_load(struct warpy* warpy,
+                                             float megabytes);
+float get_memory_used(struct warpy* warpy);
 void update_vocoder_settings(struct warpy* warpy,
                              const struct vocoder_settings settings);
 void update_gain(struct warpy* warpy, float norm_gain);
@@ -94,6 +147,7 @@ void update_vibrato_waveform_type(struct warpy* warpy, unsigned waveform_type);
 void update_vibrato_tempo_toggle(struct warpy* warpy, bool tempo_toggle);
 void update_vibrato_freq(struct warpy* warpy, float freq);
 void update_vibrato_tempo_fraction(struct warpy* warpy, unsigned tempo_fraction);
+void update_vibrato_retrigger(struct warpy* warpy, bool retrigger);
 
 void update_chorus_voices(struct warpy* warpy, unsigned voices);
 void update_chorus_mix(struct warpy* warpy, float mix);
@@ -103,4 +157,19 @@ void update_chorus_stereo_spread(struct warpy* warpy, float spread);
 void update_note_pan_center(struct warpy* warpy, float center);
 void update_note_pan_amount(struct warpy* warpy, float amount);
 
+// true when the size moved, and the machinery has to be replanned with
+// prepare_fft_machinery off the audio thread
+bool update_fft_size(struct warpy* warpy, unsigned size);
+void update_fft_overlap(struct warpy* warpy, unsigned overlap);
+void update_low_latency(struct warpy* warpy, bool low_latency);
+void update_interpolation(struct warpy* warpy, unsigned mode);
+void update_preserve_transients(struct warpy* warpy, bool preserve);
+void update_preserve_formants(struct warpy* warpy, bool preserve);
+uint32_t get_latency(struct warpy* warpy);
+
+void update_cpu_budget(struct warpy* warpy,
+                       float usecs_per_block,
+                       uint32_t block_frames);
+unsigned get_quality_tier(struct warpy* warpy);
+
 #endif
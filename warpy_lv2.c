@@ -1,5 +1,8 @@
 #include <malloc.h>
+#include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <pthread.h>
 
 #include <lv2/lv2plug.in/ns/lv2core/lv2.h>
 #include <lv2/lv2plug.in/ns/ext/atom/forge.h>
@@ -8,11 +11,39 @@
 #include <lv2/lv2plug.in/ns/ext/midi/midi.h>
 #include <lv2/lv2plug.in/ns/ext/atom/atom.h>
 #include <lv2/lv2plug.in/ns/ext/patch/patch.h>
+#include <lv2/lv2plug.in/ns/ext/state/state.h>
+#include <lv2/lv2plug.in/ns/ext/worker/worker.h>
 
 #include "warpy.h"
+#include "rt_check.h"
 
 #define WARPY_URI "https://milky.flowers/programs/warpy"
 #define WARPY__sample WARPY_URI "#sample"
+#define WARPY__keymap WARPY_URI "#keymap"
+#define WARPY__bank WARPY_URI "#bank"
+#define WARPY__parts WARPY_URI "#parts"
+#define WARPY__sampleHash WARPY_URI "#sampleHash"
+
+#define WORK_LOAD  0
+#define WORK_FREE  1
+#define WORK_CHECK 2
+#define WORK_RENDER_CACHE 3
+#define WORK_FFT_SIZE 4
+
+// how often the worker looks for the sample changing on disk, and
+// prints what the audio thread couldn't
+#define CHECK_SECONDS 1
+
+// a load carries its path right after this
+struct work_message {
+	uint32_t              type;
+	int                   kind;
+	uint64_t              hash;
+	struct warpy_load*    load;
+	float                 megabytes;
+	struct warpy_warnings warnings;
+	uint32_t              bad_patch_sets;
+};
 
 enum port_indices {
 	WARPY_IN,
@@ -58,7 +89,21 @@ enum port_indices {
 	WARPY_RELEASE_SHAPE,
 	WARPY_NOTE_PAN_CENTER,
 	WARPY_NOTE_PAN_AMT,
-	WARPY_GAIN
+	WARPY_GAIN,
+	WARPY_FFT_SIZE,
+	WARPY_FFT_OVERLAP,
+	WARPY_LOW_LATENCY,
+	WARPY_LATENCY,
+	WARPY_INTERPOLATION,
+	WARPY_CPU_BUDGET,
+	WARPY_QUALITY_TIER,
+	WARPY_VIBRATO_RETRIGGER,
+	WARPY_PRESET,
+	WARPY_MEMORY_LIMIT,
+	WARPY_MEMORY_USED,
+	WARPY_PRESERVE_TRANSIENTS,
+	WARPY_PRESERVE_FORMANTS,
+	WARPY_RENDER_CACHE
 };
 
 struct lv2 {
@@ -109,17 +154,57 @@ struct lv2 {
 		float*                   note_pan_center;
 		float*                   note_pan_amt;
 		float*                   gain;
+		float*                   fft_size;
+		float*                   fft_overlap;
+		float*                   low_latency;
+		float*                   latency;
+		float*                   interpolation;
+		float*                   cpu_budget;
+		float*                   quality_tier;
+		float*                   vibrato_retrigger;
+		float*                   preset;
+		float*                   memory_limit;
+		float*                   memory_used;
+		float*                   preserve_transients;
+		float*                   preserve_formants;
+		float*                   render_cache;
 	} ports;
 
 	LV2_URID_Map* urid_map;
+	LV2_Worker_Schedule* schedule;
 	LV2_Atom_Forge forge;
+	double sample_rate;
+	uint64_t frames_since_check;
+	// patch sets run ignored, reported along with the check
+	uint32_t bad_patch_sets;
+	// asked of the worker again each period until it takes them
+	bool fft_machinery_pending;
+	bool render_cache_pending;
+
+	// what save writes out, written once a load has been prepared
+	pthread_mutex_t state_lock;
+	struct {
+		char*    sample;
+		uint64_t sample_hash;
+		uint64_t sample_identity;
+		char*    keymap;
+		char*    bank;
+		char*    parts;
+	} state;
+
 	struct {
 		LV2_URID atom_urid;
+		LV2_URID atom_path;
+		LV2_URID atom_long;
 		LV2_URID midi_event;
 		LV2_URID patch_set;
 		LV2_URID patch_set_property;
 		LV2_URID patch_set_value;
 		LV2_URID warpy_sample;
+		LV2_URID warpy_keymap;
+		LV2_URID warpy_bank;
+		LV2_URID warpy_parts;
+		LV2_URID warpy_sample_hash;
 	} uris;
 };
 
@@ -127,6 +212,10 @@ static void map_urids(struct lv2* lv2)
 {
 	lv2->uris.atom_urid =
 	        lv2->urid_map->map(lv2->urid_map->handle, LV2_ATOM__URID);
+	lv2->uris.atom_path =
+	        lv2->urid_map->map(lv2->urid_map->handle, LV2_ATOM__Path);
+	lv2->uris.atom_long =
+	        lv2->urid_map->map(lv2->urid_map->handle, LV2_ATOM__Long);
 	lv2->uris.midi_event =
 	        lv2->urid_map->map(lv2->urid_map->handle, LV2_MIDI__MidiEvent);
 	lv2->uris.patch_set =
@@ -137,6 +226,14 @@ static void map_urids(struct lv2* lv2)
 	        lv2->urid_map->map(lv2->urid_map->handle, LV2_PATCH__value);
 	lv2->uris.warpy_sample =
 	        lv2->urid_map->map(lv2->urid_map->handle, WARPY__sample);
+	lv2->uris.warpy_keymap =
+	        lv2->urid_map->map(lv2->urid_map->handle, WARPY__keymap);
+	lv2->uris.warpy_bank =
+	        lv2->urid_map->map(lv2->urid_map->handle, WARPY__bank);
+	lv2->uris.warpy_parts =
+	        lv2->urid_map->map(lv2->urid_map->handle, WARPY__parts);
+	lv2->uris.warpy_sample_hash =
+	        lv2->urid_map->map(lv2->urid_map->handle, WARPY__sampleHash);
 }
 
 static LV2_Handle instantiate(const LV2_Descriptor*     descriptor,
@@ -146,13 +243,42 @@ static LV2_Handle instantiate(const LV2_Descriptor*     descriptor,
 {
 
 	struct lv2* lv2 = (struct lv2*)malloc(sizeof(struct lv2));
+	if (!lv2)
+		return NULL;
 
 	struct warpy* warpy = create_warpy(rate);
+	if (!warpy) {
+		free(lv2);
+		return NULL;
+	}
 	lv2->warpy = warpy;
 
-	for (int i = 0; features[i]; i++)
+	// the Csound orchestra is still around for comparing against
+	const char* backend = getenv("WARPY_BACKEND");
+	if (backend && !strcmp(backend, "csound"))
+		select_backend(warpy, WARPY_BACKEND_CSOUND);
+
+	// without a worker, only restore can load
+	lv2->schedule = NULL;
+	lv2->sample_rate = rate;
+	lv2->frames_since_check = 0;
+	lv2->bad_patch_sets = 0;
+	lv2->fft_machinery_pending = false;
+	lv2->render_cache_pending = false;
+	for (int i = 0; features[i]; i++) {
 		if (!strcmp(features[i]->URI, LV2_URID__map))
 			lv2->urid_map = (LV2_URID_Map*)features[i]->data;
+		else if (!strcmp(features[i]->URI, LV2_WORKER__schedule))
+			lv2->schedule = (LV2_Worker_Schedule*)features[i]->data;
+	}
+
+	pthread_mutex_init(&lv2->state_lock, NULL);
+	lv2->state.sample = NULL;
+	lv2->state.sample_hash = 0;
+	lv2->state.sample_identity = 0;
+	lv2->state.keymap = NULL;
+	lv2->state.bank = NULL;
+	lv2->state.parts = NULL;
 
 	lv2_atom_forge_init(&lv2->forge, lv2->urid_map);
 
@@ -300,6 +426,48 @@ static void connect_port(LV2_Handle instance,
 		case WARPY_GAIN:
 			lv2->ports.gain = (float*)data;
 			break;
+		case WARPY_FFT_SIZE:
+			lv2->ports.fft_size = (float*)data;
+			break;
+		case WARPY_FFT_OVERLAP:
+			lv2->ports.fft_overlap = (float*)data;
+			break;
+		case WARPY_LOW_LATENCY:
+			lv2->ports.low_latency = (float*)data;
+			break;
+		case WARPY_LATENCY:
+			lv2->ports.latency = (float*)data;
+			break;
+		case WARPY_INTERPOLATION:
+			lv2->ports.interpolation = (float*)data;
+			break;
+		case WARPY_CPU_BUDGET:
+			lv2->ports.cpu_budget = (float*)data;
+			break;
+		case WARPY_QUALITY_TIER:
+			lv2->ports.quality_tier = (float*)data;
+			break;
+		case WARPY_VIBRATO_RETRIGGER:
+			lv2->ports.vibrato_retrigger = (float*)data;
+			break;
+		case WARPY_PRESET:
+			lv2->ports.preset = (float*)data;
+			break;
+		case WARPY_MEMORY_LIMIT:
+			lv2->ports.memory_limit = (float*)data;
+			break;
+		case WARPY_MEMORY_USED:
+			lv2->ports.memory_used = (float*)data;
+			break;
+		case WARPY_PRESERVE_TRANSIENTS:
+			lv2->ports.preserve_transients = (float*)data;
+			break;
+		case WARPY_PRESERVE_FORMANTS:
+			lv2->ports.preserve_formants = (float*)data;
+			break;
+		case WARPY_RENDER_CACHE:
+			lv2->ports.render_cache = (float*)data;
+			break;
 	}
 }
 
@@ -309,6 +477,31 @@ static void activate(LV2_Handle instance)
 	start_warpy(lv2->warpy);
 }
 
+// the arena can run to hundreds of megabytes, so only the worker
+// allocates it; without one the cache stays as it is
+static bool request_render_cache(struct lv2* lv2, const float megabytes)
+{
+	const struct work_message head = {
+		WORK_RENDER_CACHE, WARPY_LOAD_RENDER_CACHE, 0, NULL, megabytes
+	};
+	return lv2->schedule &&
+	       lv2->schedule->schedule_work(lv2->schedule->handle,
+	                                    sizeof(struct work_message),
+	                                    &head) == LV2_WORKER_SUCCESS;
+}
+
+// replanning all the machinery takes far longer than a period, so the
+// worker does that too; until it has, notes stand in on the machinery
+// at the old size
+static bool request_fft_machinery(struct lv2* lv2)
+{
+	const struct work_message head = { WORK_FFT_SIZE, 0, 0, NULL };
+	return lv2->schedule &&
+	       lv2->schedule->schedule_work(lv2->schedule->handle,
+	                                    sizeof(struct work_message),
+	                                    &head) == LV2_WORKER_SUCCESS;
+}
+
 static void update_control_ports(struct lv2* lv2)
 {
 	update_bpm(lv2->warpy, *(lv2->ports.bpm));
@@ -345,6 +538,7 @@ static void update_control_ports(struct lv2* lv2)
 	                           *(lv2->ports.vibrato_tempo_toggle));
 	update_vibrato_tempo_fraction(lv2->warpy,
 	                             *(lv2->ports.vibrato_tempo_fraction));
+	update_vibrato_retrigger(lv2->warpy, *(lv2->ports.vibrato_retrigger));
 
 	update_chorus_voices(lv2->warpy, *(lv2->ports.chorus_voices));
 	update_chorus_mix(lv2->warpy, *(lv2->ports.chorus_mix));
@@ -353,6 +547,26 @@ static void update_control_ports(struct lv2* lv2)
 	                            *(lv2->ports.chorus_stereo_spread));
 	update_note_pan_center(lv2->warpy, *(lv2->ports.note_pan_center));
 	update_note_pan_amount(lv2->warpy, *(lv2->ports.note_pan_amt));
+	if (update_fft_size(lv2->warpy, *(lv2->ports.fft_size)))
+		lv2->fft_machinery_pending = true;
+	if (lv2->fft_machinery_pending)
+		lv2->fft_machinery_pending = !request_fft_machinery(lv2);
+	update_fft_overlap(lv2->warpy, *(lv2->ports.fft_overlap));
+	update_low_latency(lv2->warpy, *(lv2->ports.low_latency));
+	update_interpolation(lv2->warpy, *(lv2->ports.interpolation));
+	update_preserve_transients(lv2->warpy,
+	                           *(lv2->ports.preserve_transients));
+	update_preserve_formants(lv2->warpy, *(lv2->ports.preserve_formants));
+	*(lv2->ports.latency) = get_latency(lv2->warpy);
+	*(lv2->ports.quality_tier) = get_quality_tier(lv2->warpy);
+	update_preset(lv2->warpy, *(lv2->ports.preset));
+	update_memory_limit(lv2->warpy, *(lv2->ports.memory_limit));
+	if (update_render_cache(lv2->warpy, *(lv2->ports.render_cache)))
+		lv2->render_cache_pending = true;
+	if (lv2->render_cache_pending)
+		lv2->render_cache_pending =
+		        !request_render_cache(lv2, *(lv2->ports.render_cache));
+	*(lv2->ports.memory_used) = get_memory_used(lv2->warpy);
 
 	struct envelope env;
 	env.attack_time   = *(lv2->ports.attack_time);
@@ -381,6 +595,75 @@ static void update_control_ports(struct lv2* lv2)
 	update_vocoder_settings(lv2->warpy, pitch_settings);
 }
 
+static void replace_string(char** field, const char* value)
+{
+	free(*field);
+	*field = value ? strdup(value) : NULL;
+}
+
+// a sample and a keymap both take the loose keymap, so only the last one
+// is worth saving
+static void record_load(struct lv2* lv2,
+                        const int kind,
+                        const char* path,
+                        const struct warpy_load* load)
+{
+	pthread_mutex_lock(&lv2->state_lock);
+	if (kind == WARPY_LOAD_SAMPLE) {
+		replace_string(&lv2->state.sample, path);
+		lv2->state.sample_hash = get_load_hash(load);
+		lv2->state.sample_identity = get_load_identity(load);
+		replace_string(&lv2->state.keymap, NULL);
+	} else if (kind == WARPY_LOAD_KEYMAP) {
+		replace_string(&lv2->state.keymap, path);
+		replace_string(&lv2->state.sample, NULL);
+		lv2->state.sample_hash = 0;
+		lv2->state.sample_identity = 0;
+	} else if (kind == WARPY_LOAD_BANK) {
+		replace_string(&lv2->state.bank, path);
+	} else {
+		replace_string(&lv2->state.parts, path);
+	}
+	pthread_mutex_unlock(&lv2->state_lock);
+}
+
+static void load_in_place(struct lv2* lv2,
+                          const int kind,
+                          const char* path,
+                          const uint64_t hash)
+{
+	struct warpy_load* load = prepare_load(lv2->warpy, kind, path, hash);
+	if (!load)
+		return;
+	record_load(lv2, kind, path, load);
+	free_load(finish_load(lv2->warpy, load));
+}
+
+static bool schedule_load(LV2_Worker_Schedule* schedule,
+                          const int kind,
+                          const char* path,
+                          const uint64_t hash)
+{
+	const struct work_message head = { WORK_LOAD, kind, hash, NULL };
+	const size_t path_size = strlen(path) + 1;
+	uint8_t message[sizeof(struct work_message) + path_size];
+	memcpy(message, &head, sizeof(struct work_message));
+	memcpy(message + sizeof(struct work_message), path, path_size);
+	return schedule->schedule_work(schedule->handle,
+	                               sizeof(message),
+	                               message) == LV2_WORKER_SUCCESS;
+}
+
+static void request_load(struct lv2* lv2,
+                         LV2_Worker_Schedule* schedule,
+                         const int kind,
+                         const char* path,
+                         const uint64_t hash)
+{
+	if (!schedule || !schedule_load(schedule, kind, path, hash))
+		load_in_place(lv2, kind, path, hash);
+}
+
 static void process_patch_set(struct lv2* lv2, const LV2_Atom_Object* obj)
 {
 	const LV2_Atom* property = NULL;
@@ -390,57 +673,110 @@ static void process_patch_set(struct lv2* lv2, const LV2_Atom_Object* obj)
 			    lv2->uris.patch_set_value,    &value,
 			    0);
 
-	if (!property) {
-		fprintf(stderr, "Patch set message sent with no property\n");
-		return;
-	} else if (property->type != lv2->uris.atom_urid) {
-		fprintf(stderr, "Patch set message property is not a URID\n");
+	if (!property || property->type != lv2->uris.atom_urid) {
+		lv2->bad_patch_sets++;
 		return;
 	}
 
 	const uint32_t key = ((const LV2_Atom_URID*)property)->body;
-	if (key == lv2->uris.warpy_sample) {
-		char* sample_path = LV2_ATOM_BODY(value);
-		update_sample_path(lv2->warpy, sample_path);
+	int kind;
+	if (key == lv2->uris.warpy_sample)
+		kind = WARPY_LOAD_SAMPLE;
+	else if (key == lv2->uris.warpy_keymap)
+		kind = WARPY_LOAD_KEYMAP;
+	else if (key == lv2->uris.warpy_bank)
+		kind = WARPY_LOAD_BANK;
+	else if (key == lv2->uris.warpy_parts)
+		kind = WARPY_LOAD_PARTS;
+	else
+		return;
+
+	const char* path = LV2_ATOM_BODY(value);
+	if (kind == WARPY_LOAD_SAMPLE && is_current_sample(lv2->warpy, path))
+		return;
+	// decoding here would hold up the audio thread, so a host without
+	// a worker, or with its queue full, doesn't get the load
+	if (lv2->schedule)
+		schedule_load(lv2->schedule, kind, path, 0);
+}
+static void process_incoming_event(struct lv2* lv2,
+                                   const LV2_Atom_Event* event)
+{
+	if (event->body.type == lv2->uris.midi_event) {
+		uint8_t* raw = (uint8_t*)LV2_ATOM_BODY(&event->body);
+		uint64_t size = event->body.size;
+		send_midi_message(lv2->warpy, raw, size);
+	}
+	else if (lv2_atom_forge_is_object_type
+	        (&lv2->forge, event->body.type)) {
+		const LV2_Atom_Object* obj =
+		        (const LV2_Atom_Object*)&event->body;
+		if (obj->body.otype == lv2->uris.patch_set)
+			process_patch_set(lv2, obj);
+	};
+}
+
+static void render(struct lv2* lv2, const uint32_t from, const uint32_t to)
+{
+	float* out_l = lv2->ports.out_l;
+	float* out_r = lv2->ports.out_r;
+	for (uint32_t i = from; i < to; i++) {
+		struct audio_sample sample = gen_sample(lv2->warpy);
+		out_l[i] = sample.left;
+		out_r[i] = sample.right;
 	}
 }
-static void process_incoming_events(struct lv2* lv2)
+
+// the audio is rendered up to each event before it's sent, so a note
+// starts with the control period its frame falls in rather than with the
+// block
+static void render_with_events(struct lv2* lv2, const uint32_t times)
 {
+	uint32_t frame = 0;
 	LV2_ATOM_SEQUENCE_FOREACH(lv2->ports.in, event) {
-		if (event->body.type == lv2->uris.midi_event) {
-			uint8_t* raw = (uint8_t*)LV2_ATOM_BODY(&event->body);
-			uint64_t size = event->body.size;
-			send_midi_message(lv2->warpy, raw, size);
+		const uint32_t at = event->time.frames < times ?
+		                    (uint32_t)event->time.frames : times;
+		if (at > frame) {
+			render(lv2, frame, at);
+			frame = at;
 		}
-		else if (lv2_atom_forge_is_object_type
-		        (&lv2->forge, event->body.type)) {
-			const LV2_Atom_Object* obj =
-			        (const LV2_Atom_Object*)&event->body;
-			if (obj->body.otype == lv2->uris.patch_set)
-				process_patch_set(lv2, obj);
-		};
+		process_incoming_event(lv2, event);
 	}
+	render(lv2, frame, times);
+}
+
+static void schedule_check(struct lv2* lv2, const uint32_t times)
+{
+	lv2->frames_since_check += times;
+	if (!lv2->schedule ||
+	    lv2->frames_since_check < lv2->sample_rate * CHECK_SECONDS)
+		return;
+	lv2->frames_since_check = 0;
+	struct work_message head = { WORK_CHECK, 0, 0, NULL };
+	head.warnings = take_warpy_warnings(lv2->warpy);
+	head.bad_patch_sets = lv2->bad_patch_sets;
+	lv2->bad_patch_sets = 0;
+	lv2->schedule->schedule_work(lv2->schedule->handle,
+	                             sizeof(struct work_message),
+	                             &head);
 }
 
 static void run(LV2_Handle instance, uint32_t times)
 {
 	struct lv2* lv2 = (struct lv2*)instance;
+	enter_realtime();
 
 	if (times == 0) {
 		update_control_ports(lv2);
+		leave_realtime();
 		return;
 	}
 
 	update_control_ports(lv2);
-	process_incoming_events(lv2);
-
-	for (int i = 0; i < times; i++) {
-		struct audio_sample sample = gen_sample(lv2->warpy);
-		float* out_l = lv2->ports.out_l;
-		float* out_r = lv2->ports.out_r;
-		out_l[i] = sample.left;
-		out_r[i] = sample.right;
-	}
+	update_cpu_budget(lv2->warpy, *(lv2->ports.cpu_budget), times);
+	render_with_events(lv2, times);
+	schedule_check(lv2, times);
+	leave_realtime();
 }
 
 static void deactivate(LV2_Handle instance)
@@ -453,11 +789,257 @@ static void cleanup(LV2_Handle instance)
 {
 	struct lv2* lv2 = (struct lv2*)instance;
 	destroy_warpy(lv2->warpy);
+	pthread_mutex_destroy(&lv2->state_lock);
+	free(lv2->state.sample);
+	free(lv2->state.keymap);
+	free(lv2->state.bank);
+	free(lv2->state.parts);
 	free(lv2);
 }
 
+// the identity changes with the file, and the fresh decode takes the
+// stale copy's place in the shared cache
+static LV2_Worker_Status check_sample(struct lv2*                 lv2,
+                                      LV2_Worker_Respond_Function respond,
+                                      LV2_Worker_Respond_Handle   handle)
+{
+	pthread_mutex_lock(&lv2->state_lock);
+	char* path = lv2->state.sample ? strdup(lv2->state.sample) : NULL;
+	const uint64_t identity = lv2->state.sample_identity;
+	pthread_mutex_unlock(&lv2->state_lock);
+	if (!path)
+		return LV2_WORKER_SUCCESS;
+
+	struct warpy_load* load = NULL;
+	if (has_sample_changed(path, identity)) {
+		load = prepare_load(lv2->warpy, WARPY_LOAD_SAMPLE, path, 0);
+		if (load)
+			record_load(lv2, WARPY_LOAD_SAMPLE, path, load);
+	}
+	free(path);
+	if (!load)
+		return LV2_WORKER_SUCCESS;
+	return respond(handle, sizeof(struct warpy_load*), &load);
+}
+
+static LV2_Worker_Status work(LV2_Handle                  instance,
+                              LV2_Worker_Respond_Function respond,
+                              LV2_Worker_Respond_Handle   handle,
+                              uint32_t                    size,
+                              const void*                 data)
+{
+	struct lv2* lv2 = (struct lv2*)instance;
+
+	struct work_message head;
+	memcpy(&head, data, sizeof(struct work_message));
+	if (head.type == WORK_FREE) {
+		free_load(head.load);
+		release_retired_samples(lv2->warpy);
+		return LV2_WORKER_SUCCESS;
+	} else if (head.type == WORK_CHECK) {
+		report_warpy_warnings(&head.warnings);
+		if (head.bad_patch_sets)
+			fprintf(stderr,
+			        "WARN: %u patch set messages without a URID "
+			        "property ignored\n",
+			        head.bad_patch_sets);
+		release_retired_samples(lv2->warpy);
+		// machinery that was busy when the size moved
+		prepare_fft_machinery(lv2->warpy);
+		return check_sample(lv2, respond, handle);
+	} else if (head.type == WORK_FFT_SIZE) {
+		prepare_fft_machinery(lv2->warpy);
+		return LV2_WORKER_SUCCESS;
+	} else if (head.type == WORK_RENDER_CACHE) {
+		struct warpy_load* load =
+		        prepare_render_cache_load(lv2->warpy, head.megabytes);
+		if (!load)
+			return LV2_WORKER_ERR_UNKNOWN;
+		return respond(handle, sizeof(struct warpy_load*), &load);
+	}
+
+	const char* path = (const char*)data + sizeof(struct work_message);
+	struct warpy_load* load =
+	        prepare_load(lv2->warpy, head.kind, path, head.hash);
+	if (!load)
+		return LV2_WORKER_ERR_UNKNOWN;
+	record_load(lv2, head.kind, path, load);
+	return respond(handle, sizeof(struct warpy_load*), &load);
+}
+
+static LV2_Worker_Status work_response(LV2_Handle  instance,
+                                       uint32_t    size,
+                                       const void* data)
+{
+	struct lv2* lv2 = (struct lv2*)instance;
+
+	struct warpy_load* load;
+	memcpy(&load, data, sizeof(struct warpy_load*));
+	if (!load)
+		return LV2_WORKER_SUCCESS;
+	struct warpy_load* replaced = finish_load(lv2->warpy, load);
+	if (!replaced)
+		return LV2_WORKER_SUCCESS;
+
+	// freeing samples can mean freeing megabytes, so back to the worker
+	const struct work_message head = { WORK_FREE, 0, 0, replaced };
+	if (!lv2->schedule ||
+	    lv2->schedule->schedule_work(lv2->schedule->handle,
+	                                 sizeof(struct work_message),
+	                                 &head) != LV2_WORKER_SUCCESS)
+		free_load(replaced);
+	return LV2_WORKER_SUCCESS;
+}
+
+static const void* find_feature(const LV2_Feature* const* features,
+                                const char* uri)
+{
+	for (int i = 0; features && features[i]; i++)
+		if (!strcmp(features[i]->URI, uri))
+			return features[i]->data;
+	return NULL;
+}
+
+static void free_path(const LV2_Feature* const* features, char* path)
+{
+	const LV2_State_Free_Path* free_path =
+	        find_feature(features, LV2_STATE__freePath);
+	if (free_path)
+		free_path->free_path(free_path->handle, path);
+	else
+		free(path);
+}
+
+static void store_path(struct lv2*               lv2,
+                       LV2_State_Store_Function  store,
+                       LV2_State_Handle          handle,
+                       const LV2_Feature* const* features,
+                       const LV2_URID            key,
+                       const char*               path)
+{
+	if (!path)
+		return;
+
+	const LV2_State_Map_Path* map_path =
+	        find_feature(features, LV2_STATE__mapPath);
+	char* abstract = map_path ?
+	                 map_path->abstract_path(map_path->handle, path) :
+	                 NULL;
+	const char* stored = abstract ? abstract : path;
+	store(handle,
+	      key,
+	      stored,
+	      strlen(stored) + 1,
+	      lv2->uris.atom_path,
+	      LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE);
+	if (abstract)
+		free_path(features, abstract);
+}
+
+static LV2_State_Status save(LV2_Handle                instance,
+                             LV2_State_Store_Function  store,
+                             LV2_State_Handle          handle,
+                             uint32_t                  flags,
+                             const LV2_Feature* const* features)
+{
+	struct lv2* lv2 = (struct lv2*)instance;
+
+	pthread_mutex_lock(&lv2->state_lock);
+	store_path(lv2, store, handle, features,
+	           lv2->uris.warpy_sample, lv2->state.sample);
+	if (lv2->state.sample && lv2->state.sample_hash) {
+		const int64_t hash = (int64_t)lv2->state.sample_hash;
+		store(handle,
+		      lv2->uris.warpy_sample_hash,
+		      &hash,
+		      sizeof(int64_t),
+		      lv2->uris.atom_long,
+		      LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE);
+	}
+	store_path(lv2, store, handle, features,
+	           lv2->uris.warpy_keymap, lv2->state.keymap);
+	store_path(lv2, store, handle, features,
+	           lv2->uris.warpy_bank, lv2->state.bank);
+	store_path(lv2, store, handle, features,
+	           lv2->uris.warpy_parts, lv2->state.parts);
+	pthread_mutex_unlock(&lv2->state_lock);
+
+	return LV2_STATE_SUCCESS;
+}
+
+static void restore_path(struct lv2*                 lv2,
+                         LV2_State_Retrieve_Function retrieve,
+                         LV2_State_Handle            handle,
+                         const LV2_Feature* const*   features,
+                         const LV2_URID              key,
+                         const int                   kind,
+                         const uint64_t              hash)
+{
+	size_t   size;
+	uint32_t type;
+	uint32_t flags;
+	const char* path = retrieve(handle, key, &size, &type, &flags);
+	if (!path || type != lv2->uris.atom_path)
+		return;
+
+	const LV2_State_Map_Path* map_path =
+	        find_feature(features, LV2_STATE__mapPath);
+	char* absolute = map_path ?
+	                 map_path->absolute_path(map_path->handle, path) :
+	                 NULL;
+
+	// restore never runs alongside run, so without a worker to hand
+	// it to the load can happen right here
+	LV2_Worker_Schedule* schedule =
+	        (LV2_Worker_Schedule*)find_feature(features,
+	                                           LV2_WORKER__schedule);
+	request_load(lv2, schedule, kind, absolute ? absolute : path, hash);
+	if (absolute)
+		free_path(features, absolute);
+}
+
+// the saved hash lets the shared sample cache stand in for a decode
+static LV2_State_Status restore(LV2_Handle                  instance,
+                                LV2_State_Retrieve_Function retrieve,
+                                LV2_State_Handle            handle,
+                                uint32_t                    flags,
+                                const LV2_Feature* const*   features)
+{
+	struct lv2* lv2 = (struct lv2*)instance;
+
+	size_t   size;
+	uint32_t type;
+	uint32_t value_flags;
+	uint64_t hash = 0;
+	const void* value = retrieve(handle,
+	                             lv2->uris.warpy_sample_hash,
+	                             &size,
+	                             &type,
+	                             &value_flags);
+	if (value && type == lv2->uris.atom_long && size == sizeof(int64_t))
+		memcpy(&hash, value, sizeof(uint64_t));
+
+	restore_path(lv2, retrieve, handle, features,
+	             lv2->uris.warpy_sample, WARPY_LOAD_SAMPLE, hash);
+	restore_path(lv2, retrieve, handle, features,
+	             lv2->uris.warpy_keymap, WARPY_LOAD_KEYMAP, 0);
+	restore_path(lv2, retrieve, handle, features,
+	             lv2->uris.warpy_bank, WARPY_LOAD_BANK, 0);
+	restore_path(lv2, retrieve, handle, features,
+	             lv2->uris.warpy_parts, WARPY_LOAD_PARTS, 0);
+
+	return LV2_STATE_SUCCESS;
+}
+
 static const void* extension_data(const char *uri)
 {
+	static const LV2_State_Interface state = { save, restore };
+	static const LV2_Worker_Interface worker = { work, work_response, NULL };
+
+	if (!strcmp(uri, LV2_STATE__interface))
+		return &state;
+	if (!strcmp(uri, LV2_WORKER__interface))
+		return &worker;
 	return NULL;
 }
 